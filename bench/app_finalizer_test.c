@@ -0,0 +1,135 @@
+/*
+ * Ordering and time budget checks for the finalizers run on termination.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <app_private.h>
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures++; \
+		} \
+	} while (0)
+
+static char trace[256];
+
+static void record(void *data)
+{
+	const char *name = data;
+
+	if (trace[0] != '\0')
+	{
+		strncat(trace, " ", sizeof(trace) - strlen(trace) - 1);
+	}
+
+	strncat(trace, name, sizeof(trace) - strlen(trace) - 1);
+}
+
+static void record_slow(void *data)
+{
+	record(data);
+	usleep(30000);
+}
+
+static void record_and_add(void *data)
+{
+	record(data);
+	app_finalizer_add(record, "late");
+}
+
+static void removed(void *data)
+{
+	(void)data;
+
+	record("removed");
+}
+
+static void test_priority_order(void)
+{
+	trace[0] = '\0';
+
+	CHECK(app_finalizer_add_with_priority(record, "low", APP_FINALIZER_PRIORITY_LOW) == APP_ERROR_NONE);
+	CHECK(app_finalizer_add(record, "default1") == APP_ERROR_NONE);
+	CHECK(app_finalizer_add_with_priority(record, "critical", APP_FINALIZER_PRIORITY_CRITICAL) == APP_ERROR_NONE);
+	CHECK(app_finalizer_add(record, "default2") == APP_ERROR_NONE);
+
+	app_finalizer_execute();
+
+	CHECK(!strcmp(trace, "critical default1 default2 low"));
+}
+
+static void test_remove_tail(void)
+{
+	trace[0] = '\0';
+
+	CHECK(app_finalizer_add(record, "first") == APP_ERROR_NONE);
+	CHECK(app_finalizer_add(removed, NULL) == APP_ERROR_NONE);
+
+	// the removed node was the tail, the next one must be linked after "first"
+	CHECK(app_finalizer_remove(removed) == APP_ERROR_NONE);
+	CHECK(app_finalizer_add(record, "second") == APP_ERROR_NONE);
+	CHECK(app_finalizer_remove(removed) == APP_ERROR_INVALID_PARAMETER);
+
+	app_finalizer_execute();
+
+	CHECK(!strcmp(trace, "first second"));
+}
+
+static void test_late_addition(void)
+{
+	trace[0] = '\0';
+
+	CHECK(app_finalizer_add(record_and_add, "early") == APP_ERROR_NONE);
+
+	app_finalizer_execute();
+
+	CHECK(!strcmp(trace, "early late"));
+}
+
+static void test_budget(void)
+{
+	trace[0] = '\0';
+
+	CHECK(app_set_shutdown_time_budget(-1) == APP_ERROR_INVALID_PARAMETER);
+	CHECK(app_set_shutdown_time_budget(10) == APP_ERROR_NONE);
+
+	CHECK(app_finalizer_add(record_slow, "slow") == APP_ERROR_NONE);
+	CHECK(app_finalizer_add(record, "skipped") == APP_ERROR_NONE);
+	CHECK(app_finalizer_add_with_priority(record, "low", APP_FINALIZER_PRIORITY_LOW) == APP_ERROR_NONE);
+	CHECK(app_finalizer_add_with_priority(record_slow, "critical1", APP_FINALIZER_PRIORITY_CRITICAL) == APP_ERROR_NONE);
+	CHECK(app_finalizer_add_with_priority(record, "critical2", APP_FINALIZER_PRIORITY_CRITICAL) == APP_ERROR_NONE);
+
+	app_finalizer_execute();
+
+	// the critical finalizers run even though the first one spent the whole budget
+	CHECK(!strcmp(trace, "critical1 critical2"));
+
+	CHECK(app_set_shutdown_time_budget(0) == APP_ERROR_NONE);
+}
+
+int main(void)
+{
+	test_priority_order();
+	test_remove_tail();
+	test_late_addition();
+	test_budget();
+
+	if (failures > 0)
+	{
+		fprintf(stderr, "%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+
+	return 0;
+}
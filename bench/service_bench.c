@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Microbenchmarks for the service API.
+ *
+ * usage: service_bench [filter] [min time in ms]
+ *
+ * Every case reports the time and the number of heap allocations per operation,
+ * and the encoded_size lines compare the output of service_encode() and bundle_encode().
+ * The allocations are counted by wrapping the allocator of glibc.
+ * The bundle is the stub in stub/bundle.c, so the allocations made inside the
+ * bundle are those of the stub and not of the platform bundle.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <bundle.h>
+#include <appsvc.h>
+#include <aul.h>
+
+#include <app_service.h>
+#include <app_service_private.h>
+
+#define BENCH_DEFAULT_MIN_TIME 200
+#define BENCH_STRESS_THREADS 4
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+extern int service_import_from_bundle(service_h service, bundle *data);
+extern int service_export_as_bundle(service_h service, bundle **data);
+
+static unsigned long bench_allocs = 0;
+
+void *malloc(size_t size)
+{
+	__sync_fetch_and_add(&bench_allocs, 1);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	__sync_fetch_and_add(&bench_allocs, 1);
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	__sync_fetch_and_add(&bench_allocs, 1);
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+	__libc_free(ptr);
+}
+
+typedef struct {
+	int keys;
+	size_t value_size;
+	char **key_names;
+	char *value;
+	service_h service;
+	service_h request;
+	bundle *event_data;
+	bundle *reply_data;
+	void *buffer;
+	size_t length;
+} bench_fixture_s;
+
+typedef void (*bench_run_fn)(bench_fixture_s *fixture);
+
+typedef struct {
+	const char *name;
+	bench_run_fn run;
+	bool with_data;
+} bench_case_s;
+
+static long long bench_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void bench_check(int retval, const char *what)
+{
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		fprintf(stderr, "%s failed (%d)\n", what, retval);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void bench_add_extra_data(service_h service, bench_fixture_s *fixture)
+{
+	int i;
+
+	for (i=0; i<fixture->keys; i++)
+	{
+		bench_check(service_add_extra_data(service, fixture->key_names[i], fixture->value), "service_add_extra_data");
+	}
+}
+
+static void bench_fixture_init(bench_fixture_s *fixture, int keys, size_t value_size)
+{
+	bundle *request_data;
+	char key[32];
+	int i;
+
+	memset(fixture, 0, sizeof(*fixture));
+
+	fixture->keys = keys;
+	fixture->value_size = value_size;
+	fixture->key_names = calloc(keys > 0 ? keys : 1, sizeof(char *));
+
+	for (i=0; i<keys; i++)
+	{
+		snprintf(key, sizeof(key), "bench_key_%d", i);
+		fixture->key_names[i] = strdup(key);
+	}
+
+	fixture->value = malloc(value_size + 1);
+	memset(fixture->value, 'v', value_size);
+	fixture->value[value_size] = '\0';
+
+	bench_check(service_create(&fixture->service), "service_create");
+	bench_check(service_set_operation(fixture->service, SERVICE_OPERATION_VIEW), "service_set_operation");
+	bench_check(service_set_uri(fixture->service, "http://www.tizen.org"), "service_set_uri");
+	bench_add_extra_data(fixture->service, fixture);
+
+	bench_check(service_encode(fixture->service, NULL, 0, &fixture->length), "service_encode");
+	fixture->buffer = malloc(fixture->length);
+	bench_check(service_encode(fixture->service, fixture->buffer, fixture->length, &fixture->length), "service_encode");
+
+	// the launch request as the callee receives it
+	request_data = bundle_create();
+	bundle_add(request_data, AUL_K_CALLER_PID, "4242");
+	bundle_add(request_data, AUL_K_WAIT_RESULT, "1");
+	bench_check(service_create_event(request_data, &fixture->request), "service_create_event");
+	bundle_free(request_data);
+
+	// the launch request and the reply as appcore and appsvc hand them over, with the extra data of the fixture
+	bench_check(service_to_bundle(fixture->service, &request_data), "service_to_bundle");
+	fixture->event_data = bundle_dup(request_data);
+	bundle_add(fixture->event_data, AUL_K_CALLER_PID, "4242");
+	fixture->reply_data = bundle_dup(request_data);
+}
+
+static void bench_fixture_fini(bench_fixture_s *fixture)
+{
+	int i;
+
+	for (i=0; i<fixture->keys; i++)
+	{
+		free(fixture->key_names[i]);
+	}
+
+	free(fixture->key_names);
+	free(fixture->value);
+	free(fixture->buffer);
+	service_destroy(fixture->service);
+	service_destroy(fixture->request);
+	bundle_free(fixture->event_data);
+	bundle_free(fixture->reply_data);
+}
+
+static void bench_create_destroy(bench_fixture_s *fixture)
+{
+	service_h service;
+
+	(void)fixture;
+
+	bench_check(service_create(&service), "service_create");
+	service_destroy(service);
+}
+
+static void bench_clone_destroy(bench_fixture_s *fixture)
+{
+	service_h clone;
+
+	bench_check(service_clone(&clone, fixture->service), "service_clone");
+	service_destroy(clone);
+}
+
+static void bench_extra_data_add(bench_fixture_s *fixture)
+{
+	service_h service;
+
+	bench_check(service_create(&service), "service_create");
+	bench_add_extra_data(service, fixture);
+	service_destroy(service);
+}
+
+static void bench_builder_build(bench_fixture_s *fixture)
+{
+	service_builder_h builder;
+	service_h service;
+	int i;
+
+	bench_check(service_builder_create(fixture->keys, fixture->keys * (fixture->value_size + 16) + 64, &builder), "service_builder_create");
+
+	for (i=0; i<fixture->keys; i++)
+	{
+		bench_check(service_builder_add_extra_data(builder, fixture->key_names[i], fixture->value), "service_builder_add_extra_data");
+	}
+
+	bench_check(service_builder_build(builder, &service), "service_builder_build");
+	service_builder_destroy(builder);
+	service_destroy(service);
+}
+
+static void bench_extra_data_get(bench_fixture_s *fixture)
+{
+	char *value;
+	int i;
+
+	for (i=0; i<fixture->keys; i++)
+	{
+		bench_check(service_get_extra_data(fixture->service, fixture->key_names[i], &value), "service_get_extra_data");
+		free(value);
+	}
+}
+
+static bool bench_extra_data_cb(service_h service, const char *key, void *user_data)
+{
+	(void)service;
+	(void)key;
+
+	(*(int *)user_data)++;
+
+	return true;
+}
+
+static void bench_extra_data_foreach(bench_fixture_s *fixture)
+{
+	int count = 0;
+
+	bench_check(service_foreach_extra_data(fixture->service, bench_extra_data_cb, &count), "service_foreach_extra_data");
+}
+
+static void bench_export_import(bench_fixture_s *fixture)
+{
+	service_h service;
+	bundle *data;
+
+	bench_check(service_export_as_bundle(fixture->service, &data), "service_export_as_bundle");
+	bench_check(service_create(&service), "service_create");
+	bench_check(service_import_from_bundle(service, data), "service_import_from_bundle");
+	bundle_free(data);
+	service_destroy(service);
+}
+
+static void bench_encode_decode(bench_fixture_s *fixture)
+{
+	service_h service;
+	size_t length;
+
+	bench_check(service_encode(fixture->service, fixture->buffer, fixture->length, &length), "service_encode");
+	bench_check(service_decode(fixture->buffer, length, &service), "service_decode");
+	service_destroy(service);
+}
+
+// the launch request as it was received before the appcore bundle was borrowed
+static void bench_event_create(bench_fixture_s *fixture)
+{
+	service_h service;
+
+	bench_check(service_create_event(fixture->event_data, &service), "service_create_event");
+	service_destroy(service);
+}
+
+// the launch request as app_appcore_reset() receives it
+static void bench_event_create_borrowed(bench_fixture_s *fixture)
+{
+	service_h service;
+
+	bench_check(service_create_event_borrowed(fixture->event_data, &service), "service_create_event_borrowed");
+	service_destroy(service);
+}
+
+static void bench_reply_cb(service_h request, service_h reply, service_result_e result, void *user_data)
+{
+	(void)request;
+	(void)reply;
+	(void)result;
+
+	(*(int *)user_data)++;
+}
+
+// the reply handle borrows the bundle of appsvc, the request is sent for the result to be delivered to
+static void bench_reply_receive(bench_fixture_s *fixture)
+{
+	int replies = 0;
+
+	bench_check(service_send_launch_request(fixture->service, bench_reply_cb, &replies), "service_send_launch_request");
+	bench_check(stub_appsvc_deliver_result(fixture->reply_data, APPSVC_RES_OK) == 0 && replies == 1 ?
+		SERVICE_ERROR_NONE : SERVICE_ERROR_INVALID_PARAMETER, "stub_appsvc_deliver_result");
+}
+
+// the reply handle used to own a duplicate of the appsvc bundle, which cloning the borrowed reply reproduces
+static void bench_reply_copied_cb(service_h request, service_h reply, service_result_e result, void *user_data)
+{
+	service_h reply_copy;
+
+	bench_check(service_clone(&reply_copy, reply), "service_clone");
+	service_destroy(reply_copy);
+
+	bench_reply_cb(request, reply, result, user_data);
+}
+
+static void bench_reply_receive_copied(bench_fixture_s *fixture)
+{
+	int replies = 0;
+
+	bench_check(service_send_launch_request(fixture->service, bench_reply_copied_cb, &replies), "service_send_launch_request");
+	bench_check(stub_appsvc_deliver_result(fixture->reply_data, APPSVC_RES_OK) == 0 && replies == 1 ?
+		SERVICE_ERROR_NONE : SERVICE_ERROR_INVALID_PARAMETER, "stub_appsvc_deliver_result");
+}
+
+// the platform encoding of the same request, for comparison with service_encode()
+static void bench_bundle_encode_decode(bench_fixture_s *fixture)
+{
+	service_h service;
+	bundle *data;
+	bundle *decoded;
+	bundle_raw *raw;
+	int length;
+
+	bench_check(service_to_bundle(fixture->service, &data), "service_to_bundle");
+	bench_check(bundle_encode(data, &raw, &length) == 0 ? SERVICE_ERROR_NONE : SERVICE_ERROR_OUT_OF_MEMORY, "bundle_encode");
+
+	decoded = bundle_decode(raw, length);
+	free(raw);
+	bench_check(decoded != NULL ? SERVICE_ERROR_NONE : SERVICE_ERROR_OUT_OF_MEMORY, "bundle_decode");
+
+	// the handle takes the decoded bundle as it is, as service_decode() does not copy its result either
+	bench_check(service_create_event_borrowed(decoded, &service), "service_create_event_borrowed");
+	service_destroy(service);
+	bundle_free(decoded);
+}
+
+static void bench_reply(bench_fixture_s *fixture)
+{
+	service_h reply;
+
+	bench_check(service_create(&reply), "service_create");
+	bench_add_extra_data(reply, fixture);
+	bench_check(service_reply_to_launch_request(reply, fixture->request, SERVICE_RESULT_SUCCEEDED), "service_reply_to_launch_request");
+	service_destroy(reply);
+}
+
+static const bench_case_s bench_cases[] = {
+	{ "create_destroy", bench_create_destroy, false },
+	{ "clone_destroy", bench_clone_destroy, true },
+	{ "extra_data_add", bench_extra_data_add, true },
+	{ "builder_build", bench_builder_build, true },
+	{ "extra_data_get", bench_extra_data_get, true },
+	{ "extra_data_foreach", bench_extra_data_foreach, true },
+	{ "export_import", bench_export_import, true },
+	{ "encode_decode", bench_encode_decode, true },
+	{ "bundle_encode_decode", bench_bundle_encode_decode, true },
+	{ "reply", bench_reply, true },
+	{ "event_create", bench_event_create, true },
+	{ "event_create_borrowed", bench_event_create_borrowed, true },
+	{ "reply_receive", bench_reply_receive, true },
+	{ "reply_receive_copied", bench_reply_receive_copied, true },
+};
+
+static const int bench_key_counts[] = { 1, 16, 64 };
+static const size_t bench_value_sizes[] = { 16, 1024 };
+
+static void bench_report(const char *name, long iterations, long long elapsed, unsigned long allocs)
+{
+	printf("%-40s %10ld %12.1f ns/op %10.1f allocs/op\n", name, iterations,
+		(double)elapsed / iterations, (double)allocs / iterations);
+}
+
+static void bench_run(const char *name, bench_run_fn run, bench_fixture_s *fixture, long long min_time)
+{
+	unsigned long allocs;
+	long long started;
+	long long elapsed;
+	long iterations;
+	long i;
+
+	// warm up the handle pool and the caches, and find the iteration count for the minimum time
+	for (iterations=1; ; iterations*=2)
+	{
+		started = bench_now();
+
+		for (i=0; i<iterations; i++)
+		{
+			run(fixture);
+		}
+
+		if (bench_now() - started >= min_time / 10)
+		{
+			break;
+		}
+	}
+
+	iterations = iterations * 10;
+	allocs = bench_allocs;
+	started = bench_now();
+
+	for (i=0; i<iterations; i++)
+	{
+		run(fixture);
+	}
+
+	elapsed = bench_now() - started;
+
+	bench_report(name, iterations, elapsed, bench_allocs - allocs);
+}
+
+static void bench_report_encoded_size(const char *name, bench_fixture_s *fixture)
+{
+	bundle *data;
+	bundle_raw *raw;
+	int length;
+
+	bench_check(service_to_bundle(fixture->service, &data), "service_to_bundle");
+	bench_check(bundle_encode(data, &raw, &length) == 0 ? SERVICE_ERROR_NONE : SERVICE_ERROR_OUT_OF_MEMORY, "bundle_encode");
+	free(raw);
+
+	printf("%-40s %10zu bytes service_encode %10d bytes bundle_encode\n", name, fixture->length, length);
+}
+
+typedef struct {
+	service_h service;
+	long iterations;
+} bench_stress_context_s;
+
+static void *bench_stress_thread(void *data)
+{
+	bench_stress_context_s *context = data;
+	service_h service;
+	service_h clone;
+	long i;
+
+	for (i=0; i<context->iterations; i++)
+	{
+		bench_check(service_create(&service), "service_create");
+		bench_check(service_clone(&clone, context->service), "service_clone");
+		service_destroy(clone);
+		service_destroy(service);
+	}
+
+	return NULL;
+}
+
+// create, clone and destroy from several threads at once, sharing the handle pool and the ID counter
+static void bench_stress(bench_fixture_s *fixture, long long min_time)
+{
+	pthread_t threads[BENCH_STRESS_THREADS];
+	bench_stress_context_s context;
+	unsigned long allocs;
+	long long started;
+	long long elapsed;
+	int i;
+
+	context.service = fixture->service;
+	context.iterations = 1000;
+
+	for (;;)
+	{
+		allocs = bench_allocs;
+		started = bench_now();
+
+		for (i=0; i<BENCH_STRESS_THREADS; i++)
+		{
+			pthread_create(&threads[i], NULL, bench_stress_thread, &context);
+		}
+
+		for (i=0; i<BENCH_STRESS_THREADS; i++)
+		{
+			pthread_join(threads[i], NULL);
+		}
+
+		elapsed = bench_now() - started;
+
+		if (elapsed >= min_time)
+		{
+			break;
+		}
+
+		context.iterations *= 2;
+	}
+
+	bench_report("stress/threads=4/keys=16", context.iterations * BENCH_STRESS_THREADS, elapsed, bench_allocs - allocs);
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = argc > 1 ? argv[1] : NULL;
+	long long min_time = (argc > 2 ? atoll(argv[2]) : BENCH_DEFAULT_MIN_TIME) * 1000000LL;
+	bench_fixture_s fixture;
+	char name[128];
+	unsigned int c;
+	unsigned int k;
+	unsigned int v;
+
+	printf("allocations are counted against the stub bundle, not the platform one\n");
+	printf("%-40s %10s %15s %20s\n", "case", "iterations", "time", "allocations");
+
+	for (c=0; c<sizeof(bench_cases)/sizeof(bench_cases[0]); c++)
+	{
+		for (k=0; k<sizeof(bench_key_counts)/sizeof(bench_key_counts[0]); k++)
+		{
+			for (v=0; v<sizeof(bench_value_sizes)/sizeof(bench_value_sizes[0]); v++)
+			{
+				if (bench_cases[c].with_data)
+				{
+					snprintf(name, sizeof(name), "%s/keys=%d/value=%zu", bench_cases[c].name, bench_key_counts[k], bench_value_sizes[v]);
+				}
+				else
+				{
+					snprintf(name, sizeof(name), "%s", bench_cases[c].name);
+				}
+
+				if (filter == NULL || strstr(name, filter) != NULL)
+				{
+					bench_fixture_init(&fixture, bench_key_counts[k], bench_value_sizes[v]);
+					bench_run(name, bench_cases[c].run, &fixture, min_time);
+					bench_fixture_fini(&fixture);
+				}
+
+				if (!bench_cases[c].with_data)
+				{
+					break;
+				}
+			}
+
+			if (!bench_cases[c].with_data)
+			{
+				break;
+			}
+		}
+	}
+
+	for (k=0; k<sizeof(bench_key_counts)/sizeof(bench_key_counts[0]); k++)
+	{
+		for (v=0; v<sizeof(bench_value_sizes)/sizeof(bench_value_sizes[0]); v++)
+		{
+			snprintf(name, sizeof(name), "encoded_size/keys=%d/value=%zu", bench_key_counts[k], bench_value_sizes[v]);
+
+			if (filter == NULL || strstr(name, filter) != NULL)
+			{
+				bench_fixture_init(&fixture, bench_key_counts[k], bench_value_sizes[v]);
+				bench_report_encoded_size(name, &fixture);
+				bench_fixture_fini(&fixture);
+			}
+		}
+	}
+
+	if (filter == NULL || strstr("stress/threads=4/keys=16", filter) != NULL)
+	{
+		bench_fixture_init(&fixture, 16, 16);
+		bench_stress(&fixture, min_time);
+		bench_fixture_fini(&fixture);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,298 @@
+/*
+ * Checks of the binary encoding of the service API.
+ *
+ * An encoded service survives a round trip without the data bound to the
+ * running handle, and truncated or corrupted input is rejected instead of
+ * being read past its end.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <bundle.h>
+
+#include <app_service.h>
+#include <app_service_private.h>
+
+#define HEADER_SIZE 12
+#define TYPE_STR 1
+#define TYPE_STR_ARRAY 2
+#define TYPE_BYTE 3
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures++; \
+		} \
+	} while (0)
+
+typedef struct {
+	unsigned char data[256];
+	size_t length;
+} encoded_s;
+
+static void put(encoded_s *encoded, const void *data, size_t length)
+{
+	memcpy(encoded->data + encoded->length, data, length);
+	encoded->length += length;
+}
+
+static void put_uint32(encoded_s *encoded, uint32_t value)
+{
+	put(encoded, &value, sizeof(value));
+}
+
+static void put_string(encoded_s *encoded, const char *value)
+{
+	put_uint32(encoded, strlen(value) + 1);
+	put(encoded, value, strlen(value) + 1);
+}
+
+static void put_header(encoded_s *encoded, uint32_t count)
+{
+	unsigned char header[HEADER_SIZE] = { 'S', 'V', 'C', 'B', 1, };
+
+	memcpy(header + 8, &count, sizeof(count));
+	encoded->length = 0;
+	put(encoded, header, sizeof(header));
+}
+
+static void put_entry(encoded_s *encoded, unsigned char type, const char *key)
+{
+	put(encoded, &type, sizeof(type));
+	put_string(encoded, key);
+}
+
+static int decode(const encoded_s *encoded, size_t length)
+{
+	service_h service = NULL;
+	int retval;
+
+	retval = service_decode(encoded->data, length, &service);
+
+	if (retval == SERVICE_ERROR_NONE)
+	{
+		service_destroy(service);
+	}
+
+	return retval;
+}
+
+static void test_round_trip(void)
+{
+	service_h service = NULL;
+	service_h decoded = NULL;
+	const char *array[] = { "first", "second" };
+	const char payload[] = "shared memory payload";
+	bundle *data = NULL;
+	unsigned char *buffer;
+	size_t length = 0;
+	char *value = NULL;
+	char **array_value = NULL;
+	int array_length = 0;
+
+	CHECK(service_create(&service) == SERVICE_ERROR_NONE);
+	CHECK(service_set_operation(service, SERVICE_OPERATION_VIEW) == SERVICE_ERROR_NONE);
+	CHECK(service_add_extra_data(service, "key", "value") == SERVICE_ERROR_NONE);
+	CHECK(service_add_extra_data_array(service, "array", array, 2) == SERVICE_ERROR_NONE);
+	CHECK(service_add_extra_data_shm(service, "payload", payload, sizeof(payload)) == SERVICE_ERROR_NONE);
+
+	CHECK(service_encode(service, NULL, 0, &length) == SERVICE_ERROR_NONE);
+	buffer = malloc(length);
+	CHECK(buffer != NULL && service_encode(service, buffer, length, &length) == SERVICE_ERROR_NONE);
+	service_destroy(service);
+
+	CHECK(service_decode(buffer, length, &decoded) == SERVICE_ERROR_NONE);
+	free(buffer);
+
+	CHECK(service_get_operation(decoded, &value) == SERVICE_ERROR_NONE);
+	CHECK(value != NULL && !strcmp(value, SERVICE_OPERATION_VIEW));
+	free(value);
+
+	CHECK(service_get_extra_data(decoded, "key", &value) == SERVICE_ERROR_NONE);
+	CHECK(value != NULL && !strcmp(value, "value"));
+	free(value);
+
+	CHECK(service_get_extra_data_array(decoded, "array", &array_value, &array_length) == SERVICE_ERROR_NONE);
+	CHECK(array_length == 2 && !strcmp(array_value[0], "first") && !strcmp(array_value[1], "second"));
+
+	while (array_length > 0)
+	{
+		free(array_value[--array_length]);
+	}
+
+	free(array_value);
+
+	// the segment of the shared memory payload is gone once the original handle is destroyed
+	CHECK(service_to_bundle(decoded, &data) == SERVICE_ERROR_NONE);
+	CHECK(bundle_get_val(data, "__APP_SVC_SHM__payload") == NULL);
+
+	service_destroy(decoded);
+}
+
+static void test_launch_data_skipped(void)
+{
+	service_h service = NULL;
+	service_h decoded = NULL;
+	bundle *launch = bundle_create();
+	bundle *data = NULL;
+	unsigned char buffer[256];
+	size_t length = 0;
+
+	bundle_add(launch, "__AUL_CALLER_PID__", "1234");
+	bundle_add(launch, "key", "value");
+
+	CHECK(service_create_event(launch, &service) == SERVICE_ERROR_NONE);
+	bundle_free(launch);
+
+	CHECK(service_encode(service, buffer, sizeof(buffer), &length) == SERVICE_ERROR_NONE);
+	service_destroy(service);
+
+	CHECK(service_decode(buffer, length, &decoded) == SERVICE_ERROR_NONE);
+	CHECK(service_to_bundle(decoded, &data) == SERVICE_ERROR_NONE);
+	CHECK(bundle_get_val(data, "__AUL_CALLER_PID__") == NULL);
+	CHECK(bundle_get_val(data, "key") != NULL);
+
+	service_destroy(decoded);
+}
+
+static void test_truncated(void)
+{
+	encoded_s encoded;
+	size_t length;
+
+	put_header(&encoded, 3);
+	put_entry(&encoded, TYPE_STR, "key");
+	put_string(&encoded, "value");
+	put_entry(&encoded, TYPE_STR_ARRAY, "array");
+	put_uint32(&encoded, 2);
+	put_string(&encoded, "first");
+	put_string(&encoded, "second");
+	put_entry(&encoded, TYPE_BYTE, "byte");
+	put_uint32(&encoded, 4);
+	put(&encoded, "\x01\x02\x03\x04", 4);
+
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_NONE);
+
+	// every prefix of the header and of the length fields ends in the middle of a field
+	for (length = 0; length < encoded.length; length++)
+	{
+		CHECK(decode(&encoded, length) != SERVICE_ERROR_NONE);
+	}
+}
+
+static void test_corrupted_header(void)
+{
+	encoded_s encoded;
+
+	put_header(&encoded, 0);
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_NONE);
+
+	encoded.data[0] = 'X';
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	put_header(&encoded, 0);
+	encoded.data[4] = 2;
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	// the count promises more entries than the buffer holds
+	put_header(&encoded, 2);
+	put_entry(&encoded, TYPE_STR, "key");
+	put_string(&encoded, "value");
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	put_header(&encoded, UINT32_MAX);
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+}
+
+static void test_corrupted_fields(void)
+{
+	encoded_s encoded;
+	unsigned char type = TYPE_STR;
+
+	// the key length points past the end of the buffer
+	put_header(&encoded, 1);
+	put(&encoded, &type, sizeof(type));
+	put_uint32(&encoded, UINT32_MAX);
+	put(&encoded, "key", 4);
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	// an empty string has no room for the terminator
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_STR, "key");
+	put_uint32(&encoded, 0);
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	// the string is not terminated within its length
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_STR, "key");
+	put_uint32(&encoded, 5);
+	put(&encoded, "value", 5);
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	put_header(&encoded, 1);
+	put_entry(&encoded, 9, "key");
+	put_string(&encoded, "value");
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_DATA_TYPE);
+
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_STR_ARRAY, "array");
+	put_uint32(&encoded, UINT32_MAX);
+	put_string(&encoded, "first");
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_STR_ARRAY, "array");
+	put_uint32(&encoded, 3);
+	put_string(&encoded, "first");
+	put_string(&encoded, "second");
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_BYTE, "byte");
+	put_uint32(&encoded, UINT32_MAX);
+	put(&encoded, "\x01\x02\x03\x04", 4);
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+}
+
+static void test_forged_keys(void)
+{
+	encoded_s encoded;
+
+	// a decoded service never refers to a shared memory segment or to the launch data of another process
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_STR, "__APP_SVC_SHM__payload");
+	put_string(&encoded, "22:/capi-appfw-service-1-1");
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+
+	put_header(&encoded, 1);
+	put_entry(&encoded, TYPE_STR, "__AUL_CALLER_PID__");
+	put_string(&encoded, "1");
+	CHECK(decode(&encoded, encoded.length) == SERVICE_ERROR_INVALID_PARAMETER);
+}
+
+int main(void)
+{
+	test_round_trip();
+	test_launch_data_skipped();
+	test_truncated();
+	test_corrupted_header();
+	test_corrupted_fields();
+	test_forged_keys();
+
+	if (failures > 0)
+	{
+		fprintf(stderr, "%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+
+	return 0;
+}
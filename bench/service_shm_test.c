@@ -0,0 +1,302 @@
+/*
+ * Lifetime checks for the shared memory payloads of the service API.
+ *
+ * Every segment must be unlinked exactly once: by the receiver when it maps
+ * the payload, by the last handle referring to an unsent payload, or by the
+ * sender once the release timeout expires when the receiver never maps it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <bundle.h>
+#include <appsvc.h>
+#include <aul.h>
+#include <Ecore.h>
+
+#include <app_service.h>
+#include <app_service_private.h>
+
+#define SHM_KEY "payload"
+#define SHM_BUNDLE_KEY "__APP_SVC_SHM__" SHM_KEY
+
+static int failures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures++; \
+		} \
+	} while (0)
+
+static const char payload[] = "shared memory payload";
+
+// the segment name is the part of "<size>:<name>" after the separator
+static void get_segment_name(service_h service, char *name, size_t size)
+{
+	bundle *data = NULL;
+	const char *value;
+
+	name[0] = '\0';
+
+	if (service_to_bundle(service, &data) != SERVICE_ERROR_NONE)
+	{
+		return;
+	}
+
+	value = bundle_get_val(data, SHM_BUNDLE_KEY);
+
+	if (value != NULL && strchr(value, ':') != NULL)
+	{
+		snprintf(name, size, "%s", strchr(value, ':') + 1);
+	}
+}
+
+static int segment_mode(const char *name)
+{
+	struct stat st;
+	int fd;
+
+	fd = shm_open(name, O_RDONLY, 0);
+
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	close(fd);
+
+	return st.st_mode & 0777;
+}
+
+static bool segment_exists(const char *name)
+{
+	return segment_mode(name) >= 0;
+}
+
+static service_h create_request(char *name, size_t size)
+{
+	service_h service = NULL;
+
+	CHECK(service_create(&service) == SERVICE_ERROR_NONE);
+	CHECK(service_set_app_id(service, "org.tizen.receiver") == SERVICE_ERROR_NONE);
+	CHECK(service_add_extra_data_shm(service, SHM_KEY, payload, sizeof(payload)) == SERVICE_ERROR_NONE);
+
+	get_segment_name(service, name, size);
+	CHECK(name[0] == '/');
+
+	return service;
+}
+
+static void test_private_mode(void)
+{
+	char name[64];
+	service_h service = create_request(name, sizeof(name));
+
+	CHECK(segment_mode(name) == 0600);
+
+	service_destroy(service);
+}
+
+static void test_unsent_destroy(void)
+{
+	char name[64];
+	service_h service = create_request(name, sizeof(name));
+
+	CHECK(segment_exists(name));
+
+	service_destroy(service);
+
+	CHECK(!segment_exists(name));
+}
+
+static void test_unpredictable_name(void)
+{
+	char first[64];
+	char second[64];
+	service_h first_service = create_request(first, sizeof(first));
+	service_h second_service = create_request(second, sizeof(second));
+
+	// the name ends with a random part besides the pid and the sequence number
+	CHECK(strlen(strrchr(first, '-') + 1) == 16);
+	CHECK(strcmp(strrchr(first, '-'), strrchr(second, '-')) != 0);
+
+	service_destroy(first_service);
+	service_destroy(second_service);
+}
+
+static void test_failed_launch(void)
+{
+	char name[64];
+	service_h service = create_request(name, sizeof(name));
+
+	stub_appsvc_fail_launch(1);
+
+	CHECK(service_send_launch_request(service, NULL, NULL) == SERVICE_ERROR_APP_NOT_FOUND);
+	CHECK(service_send_launch_request_async(service, NULL, NULL, NULL, NULL) == SERVICE_ERROR_NONE);
+
+	stub_appsvc_fail_launch(0);
+
+	// nobody received the payload, so it does not wait for the release timeout
+	service_destroy(service);
+	CHECK(!segment_exists(name));
+}
+
+static void test_overwrite(void)
+{
+	char first[64];
+	char second[64];
+	service_h service = create_request(first, sizeof(first));
+
+	CHECK(service_add_extra_data_shm(service, SHM_KEY, payload, sizeof(payload)) == SERVICE_ERROR_NONE);
+	get_segment_name(service, second, sizeof(second));
+
+	CHECK(strcmp(first, second) != 0);
+	CHECK(!segment_exists(first));
+	CHECK(segment_exists(second));
+
+	service_destroy(service);
+
+	CHECK(!segment_exists(second));
+}
+
+static void test_clone_shares_segment(void)
+{
+	char name[64];
+	service_h service = create_request(name, sizeof(name));
+	service_h clone = NULL;
+
+	CHECK(service_clone(&clone, service) == SERVICE_ERROR_NONE);
+
+	// removing the payload from the clone must not pull it from under the original
+	CHECK(service_remove_extra_data(clone, SHM_KEY) == SERVICE_ERROR_NONE);
+	CHECK(segment_exists(name));
+
+	service_destroy(clone);
+	CHECK(segment_exists(name));
+
+	CHECK(service_clone(&clone, service) == SERVICE_ERROR_NONE);
+
+	service_destroy(service);
+	CHECK(segment_exists(name));
+
+	service_destroy(clone);
+	CHECK(!segment_exists(name));
+}
+
+static void test_never_read(void)
+{
+	char name[64];
+	service_h service = create_request(name, sizeof(name));
+
+	CHECK(service_send_launch_request(service, NULL, NULL) == SERVICE_ERROR_NONE);
+
+	// the receiver may still map the payload after the sender has dropped the handle
+	service_destroy(service);
+	CHECK(segment_exists(name));
+
+	CHECK(stub_ecore_timer_fire_all() > 0);
+	CHECK(!segment_exists(name));
+}
+
+static void test_receiver_maps(void)
+{
+	char name[64];
+	service_h service = create_request(name, sizeof(name));
+	service_h event = NULL;
+	bundle *data = NULL;
+	const void *value = NULL;
+	size_t size = 0;
+
+	CHECK(service_send_launch_request(service, NULL, NULL) == SERVICE_ERROR_NONE);
+
+	CHECK(service_to_bundle(service, &data) == SERVICE_ERROR_NONE);
+	CHECK(service_create_event(data, &event) == SERVICE_ERROR_NONE);
+
+	CHECK(service_get_extra_data_shm(event, SHM_KEY, &value, &size) == SERVICE_ERROR_NONE);
+	CHECK(size == sizeof(payload) && value != NULL && !memcmp(value, payload, size));
+	CHECK(!segment_exists(name));
+
+	service_destroy(event);
+	service_destroy(service);
+
+	// the delayed release of the sender finds the segment already gone
+	stub_ecore_timer_fire_all();
+	CHECK(!segment_exists(name));
+}
+
+static void test_reply_payload(void)
+{
+	char name[64];
+	service_h request = NULL;
+	service_h reply = NULL;
+	service_h result = NULL;
+	bundle *request_data;
+	const void *value = NULL;
+	size_t size = 0;
+
+	request_data = bundle_create();
+	bundle_add(request_data, AUL_K_CALLER_PID, "4242");
+	bundle_add(request_data, AUL_K_WAIT_RESULT, "1");
+	CHECK(service_create_event(request_data, &request) == SERVICE_ERROR_NONE);
+	bundle_free(request_data);
+
+	CHECK(service_create(&reply) == SERVICE_ERROR_NONE);
+	CHECK(service_add_extra_data_shm(reply, SHM_KEY, payload, sizeof(payload)) == SERVICE_ERROR_NONE);
+	get_segment_name(reply, name, sizeof(name));
+
+	CHECK(service_reply_to_launch_request(reply, request, SERVICE_RESULT_SUCCEEDED) == SERVICE_ERROR_NONE);
+
+	// the reply has been sent, so the caller still finds the payload after the callee drops the handle
+	service_destroy(reply);
+	CHECK(segment_exists(name));
+
+	CHECK(stub_appsvc_last_result() != NULL);
+	CHECK(service_create_event(stub_appsvc_last_result(), &result) == SERVICE_ERROR_NONE);
+
+	CHECK(service_get_extra_data_shm(result, SHM_KEY, &value, &size) == SERVICE_ERROR_NONE);
+	CHECK(size == sizeof(payload) && value != NULL && !memcmp(value, payload, size));
+	CHECK(!segment_exists(name));
+
+	service_destroy(result);
+	service_destroy(request);
+
+	stub_ecore_timer_fire_all();
+}
+
+int main(void)
+{
+	test_private_mode();
+	test_unsent_destroy();
+	test_unpredictable_name();
+	test_failed_launch();
+	test_overwrite();
+	test_clone_shares_segment();
+	test_never_read();
+	test_receiver_maps();
+	test_reply_payload();
+
+	if (failures > 0)
+	{
+		fprintf(stderr, "%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+
+	return 0;
+}
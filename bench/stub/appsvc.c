@@ -0,0 +1,281 @@
+/*
+ * Minimal appsvc, aul and Ecore for the service benchmark.
+ *
+ * The launch requests never leave the process: appsvc_run_service() returns
+ * a fake process ID and the Ecore thread runs its callbacks synchronously.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bundle.h>
+#include <appsvc.h>
+#include <aul.h>
+#include <Ecore.h>
+
+#define BENCH_LAUNCH_PID 4242
+
+static int appsvc_set(bundle *b, const char *key, const char *value)
+{
+	bundle_del(b, key);
+
+	return value != NULL ? bundle_add(b, key, value) : 0;
+}
+
+int appsvc_set_operation(bundle *b, const char *operation)
+{
+	return appsvc_set(b, "__APP_SVC_OP_TYPE__", operation);
+}
+
+int appsvc_set_uri(bundle *b, const char *uri)
+{
+	return appsvc_set(b, "__APP_SVC_URI__", uri);
+}
+
+int appsvc_set_mime(bundle *b, const char *mime)
+{
+	return appsvc_set(b, "__APP_SVC_MIME_TYPE__", mime);
+}
+
+int appsvc_set_pkgname(bundle *b, const char *pkg_name)
+{
+	return appsvc_set(b, "__APP_SVC_PKG_NAME__", pkg_name);
+}
+
+int appsvc_add_data(bundle *b, const char *key, const char *val)
+{
+	return bundle_add(b, key, val);
+}
+
+int appsvc_add_data_array(bundle *b, const char *key, const char **val_array, int len)
+{
+	return bundle_add_str_array(b, key, val_array, len);
+}
+
+const char *appsvc_get_operation(bundle *b)
+{
+	return bundle_get_val(b, "__APP_SVC_OP_TYPE__");
+}
+
+const char *appsvc_get_uri(bundle *b)
+{
+	return bundle_get_val(b, "__APP_SVC_URI__");
+}
+
+const char *appsvc_get_mime(bundle *b)
+{
+	return bundle_get_val(b, "__APP_SVC_MIME_TYPE__");
+}
+
+const char *appsvc_get_pkgname(bundle *b)
+{
+	return bundle_get_val(b, "__APP_SVC_PKG_NAME__");
+}
+
+const char *appsvc_get_data(bundle *b, const char *key)
+{
+	return bundle_get_val(b, key);
+}
+
+const char **appsvc_get_data_array(bundle *b, const char *key, int *len)
+{
+	return bundle_get_str_array(b, key, len);
+}
+
+int appsvc_data_is_array(bundle *b, const char *key)
+{
+	return bundle_get_type(b, key) == BUNDLE_TYPE_STR_ARRAY;
+}
+
+int appsvc_allow_transient_app(bundle *b, unsigned int id)
+{
+	(void)b;
+	(void)id;
+
+	return 0;
+}
+
+// the result callback of the last launch, which stub_appsvc_deliver_result() invokes as the reply arrives
+static appsvc_res_fn stub_result_cb = NULL;
+static int stub_result_request_code = 0;
+static void *stub_result_data = NULL;
+
+static int stub_launch_fails = 0;
+
+void stub_appsvc_fail_launch(int fail)
+{
+	stub_launch_fails = fail;
+}
+
+int appsvc_run_service(bundle *b, int request_code, appsvc_res_fn cbfunc, void *data)
+{
+	(void)b;
+
+	if (stub_launch_fails)
+	{
+		return -1;
+	}
+
+	stub_result_cb = cbfunc;
+	stub_result_request_code = request_code;
+	stub_result_data = data;
+
+	return BENCH_LAUNCH_PID;
+}
+
+int stub_appsvc_deliver_result(bundle *b, appsvc_result_val result)
+{
+	appsvc_res_fn cbfunc = stub_result_cb;
+
+	if (cbfunc == NULL)
+	{
+		return -1;
+	}
+
+	stub_result_cb = NULL;
+	cbfunc(b, stub_result_request_code, result, stub_result_data);
+
+	return 0;
+}
+
+int appsvc_get_list(bundle *b, appsvc_info_iter_fn iter_fn, void *data)
+{
+	(void)b;
+	(void)iter_fn;
+	(void)data;
+
+	return 0;
+}
+
+int appsvc_create_result_bundle(bundle *inb, bundle **outb)
+{
+	const char *caller_pid = bundle_get_val(inb, AUL_K_CALLER_PID);
+
+	*outb = bundle_create();
+
+	if (caller_pid != NULL)
+	{
+		bundle_add(*outb, AUL_K_CALLER_PID, caller_pid);
+	}
+
+	return 0;
+}
+
+// the last result is kept for the tests, which play the caller receiving it
+static bundle *stub_result = NULL;
+
+int appsvc_send_result(bundle *b, appsvc_result_val result)
+{
+	(void)result;
+
+	if (stub_result != NULL)
+	{
+		bundle_free(stub_result);
+	}
+
+	stub_result = bundle_dup(b);
+
+	return 0;
+}
+
+bundle *stub_appsvc_last_result(void)
+{
+	return stub_result;
+}
+
+int aul_app_get_pkgname_bypid(int pid, char *pkgname, int len)
+{
+	snprintf(pkgname, len, "org.tizen.bench%d", pid);
+
+	return AUL_R_OK;
+}
+
+struct _Ecore_Timer {
+	Ecore_Task_Cb func;
+	const void *data;
+	struct _Ecore_Timer *next;
+};
+
+// the timers never expire on their own, the tests fire them with stub_ecore_timer_fire_all()
+static Ecore_Timer *stub_timers = NULL;
+
+Ecore_Timer *ecore_timer_add(double in, Ecore_Task_Cb func, const void *data)
+{
+	Ecore_Timer *timer = malloc(sizeof(Ecore_Timer));
+
+	// the interval does not matter since the timers never expire on their own
+	(void)in;
+
+	if (timer == NULL)
+	{
+		return NULL;
+	}
+
+	timer->func = func;
+	timer->data = data;
+	timer->next = stub_timers;
+	stub_timers = timer;
+
+	return timer;
+}
+
+void *ecore_timer_del(Ecore_Timer *timer)
+{
+	Ecore_Timer **node;
+	void *data = NULL;
+
+	for (node = &stub_timers; *node != NULL; node = &(*node)->next)
+	{
+		if (*node == timer)
+		{
+			*node = timer->next;
+			data = (void *)timer->data;
+			free(timer);
+			break;
+		}
+	}
+
+	return data;
+}
+
+int stub_ecore_timer_fire_all(void)
+{
+	Ecore_Timer *timer;
+	int fired = 0;
+
+	while (stub_timers != NULL)
+	{
+		timer = stub_timers;
+		stub_timers = timer->next;
+
+		timer->func((void *)timer->data);
+		free(timer);
+		fired++;
+	}
+
+	return fired;
+}
+
+// there is no main loop to defer to, the job runs right away
+Ecore_Job *ecore_job_add(Ecore_Cb func, const void *data)
+{
+	func((void *)data);
+
+	return (Ecore_Job *)data;
+}
+
+Ecore_Thread *ecore_thread_run(Ecore_Thread_Cb func_blocking, Ecore_Thread_Cb func_end, Ecore_Thread_Cb func_cancel, const void *data)
+{
+	(void)func_cancel;
+
+	func_blocking((void *)data, NULL);
+	func_end((void *)data, NULL);
+
+	return NULL;
+}
+
+void ecore_main_loop_thread_safe_call_async(Ecore_Cb callback, void *data)
+{
+	callback(data);
+}
@@ -0,0 +1,704 @@
+/*
+ * Minimal in-memory bundle for the service benchmark.
+ *
+ * The key-values are kept in a singly linked list with separately allocated
+ * keys and values. The platform bundle allocates differently, so the
+ * allocations/op figures of the benchmark count the allocations of this stub
+ * and only compare the service cases with each other.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <bundle.h>
+
+struct keyval_t {
+	char *key;
+	int type;
+	void *val;
+	size_t size;
+	void **array;
+	size_t *array_element_size;
+	unsigned int array_len;
+	struct keyval_t *next;
+};
+
+struct _bundle_t {
+	struct keyval_t *head;
+	struct keyval_t *tail;
+};
+
+static struct keyval_t *bundle_find(bundle *b, const char *key)
+{
+	struct keyval_t *kv;
+
+	for (kv = b->head; kv != NULL; kv = kv->next)
+	{
+		if (strcmp(kv->key, key) == 0)
+		{
+			return kv;
+		}
+	}
+
+	return NULL;
+}
+
+static void bundle_keyval_free(struct keyval_t *kv)
+{
+	unsigned int i;
+
+	for (i = 0; i < kv->array_len; i++)
+	{
+		free(kv->array[i]);
+	}
+
+	free(kv->array);
+	free(kv->array_element_size);
+	free(kv->val);
+	free(kv->key);
+	free(kv);
+}
+
+static struct keyval_t *bundle_keyval_new(bundle *b, const char *key, int type)
+{
+	struct keyval_t *kv;
+
+	if (b == NULL || key == NULL || key[0] == '\0')
+	{
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (bundle_find(b, key) != NULL)
+	{
+		errno = EPERM;
+		return NULL;
+	}
+
+	kv = calloc(1, sizeof(struct keyval_t));
+
+	if (kv == NULL)
+	{
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	kv->key = strdup(key);
+	kv->type = type;
+
+	return kv;
+}
+
+static void bundle_append(bundle *b, struct keyval_t *kv)
+{
+	if (b->tail == NULL)
+	{
+		b->head = kv;
+	}
+	else
+	{
+		b->tail->next = kv;
+	}
+
+	b->tail = kv;
+}
+
+static int bundle_add_array(bundle *b, const char *key, int type, const void **values, const size_t *sizes, unsigned int len)
+{
+	struct keyval_t *kv = bundle_keyval_new(b, key, type);
+	unsigned int i;
+
+	if (kv == NULL)
+	{
+		return -1;
+	}
+
+	kv->array = calloc(len, sizeof(void *));
+	kv->array_element_size = calloc(len, sizeof(size_t));
+	kv->array_len = len;
+
+	for (i = 0; i < len; i++)
+	{
+		kv->array[i] = malloc(sizeof(char) * sizes[i]);
+		memcpy(kv->array[i], values[i], sizes[i]);
+		kv->array_element_size[i] = sizes[i];
+	}
+
+	bundle_append(b, kv);
+
+	return 0;
+}
+
+bundle* bundle_create(void)
+{
+	return calloc(1, sizeof(bundle));
+}
+
+int bundle_free(bundle *b)
+{
+	struct keyval_t *kv;
+	struct keyval_t *next;
+
+	if (b == NULL)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (kv = b->head; kv != NULL; kv = next)
+	{
+		next = kv->next;
+		bundle_keyval_free(kv);
+	}
+
+	free(b);
+
+	return 0;
+}
+
+int bundle_add_byte(bundle *b, const char *key, const void *byte, const size_t size)
+{
+	struct keyval_t *kv = bundle_keyval_new(b, key, BUNDLE_TYPE_BYTE);
+
+	if (kv == NULL)
+	{
+		return -1;
+	}
+
+	kv->val = malloc(size);
+	memcpy(kv->val, byte, size);
+	kv->size = size;
+
+	bundle_append(b, kv);
+
+	return 0;
+}
+
+int bundle_add(bundle *b, const char *key, const char *val)
+{
+	struct keyval_t *kv;
+
+	if (val == NULL)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	kv = bundle_keyval_new(b, key, BUNDLE_TYPE_STR);
+
+	if (kv == NULL)
+	{
+		return -1;
+	}
+
+	kv->val = strdup(val);
+	kv->size = strlen(val) + 1;
+
+	bundle_append(b, kv);
+
+	return 0;
+}
+
+int bundle_add_str_array(bundle *b, const char *key, const char **str_array, const int len)
+{
+	size_t sizes[len > 0 ? len : 1];
+	int i;
+
+	for (i = 0; i < len; i++)
+	{
+		sizes[i] = strlen(str_array[i]) + 1;
+	}
+
+	return bundle_add_array(b, key, BUNDLE_TYPE_STR_ARRAY, (const void **)str_array, sizes, len);
+}
+
+int bundle_del(bundle *b, const char *key)
+{
+	struct keyval_t *kv;
+	struct keyval_t *prev = NULL;
+
+	if (b == NULL || key == NULL)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (kv = b->head; kv != NULL; prev = kv, kv = kv->next)
+	{
+		if (strcmp(kv->key, key) == 0)
+		{
+			if (prev == NULL)
+			{
+				b->head = kv->next;
+			}
+			else
+			{
+				prev->next = kv->next;
+			}
+
+			if (b->tail == kv)
+			{
+				b->tail = prev;
+			}
+
+			bundle_keyval_free(kv);
+			return 0;
+		}
+	}
+
+	errno = ENOKEY;
+	return -1;
+}
+
+const char* bundle_get_val(bundle *b, const char *key)
+{
+	struct keyval_t *kv;
+
+	if (b == NULL || key == NULL)
+	{
+		errno = EINVAL;
+		return NULL;
+	}
+
+	kv = bundle_find(b, key);
+
+	if (kv == NULL || kv->type != BUNDLE_TYPE_STR)
+	{
+		errno = kv == NULL ? ENOKEY : ENOTSUP;
+		return NULL;
+	}
+
+	return kv->val;
+}
+
+const char** bundle_get_str_array(bundle *b, const char *key, int *len)
+{
+	struct keyval_t *kv = b != NULL && key != NULL ? bundle_find(b, key) : NULL;
+
+	if (kv == NULL || kv->type != BUNDLE_TYPE_STR_ARRAY)
+	{
+		errno = ENOKEY;
+		return NULL;
+	}
+
+	*len = kv->array_len;
+
+	return (const char **)kv->array;
+}
+
+int bundle_get_byte(bundle *b, const char *key, void **byte, size_t *size)
+{
+	struct keyval_t *kv = b != NULL && key != NULL ? bundle_find(b, key) : NULL;
+
+	if (kv == NULL || kv->type != BUNDLE_TYPE_BYTE)
+	{
+		errno = ENOKEY;
+		return -1;
+	}
+
+	*byte = kv->val;
+	*size = kv->size;
+
+	return 0;
+}
+
+int bundle_get_count(bundle *b)
+{
+	struct keyval_t *kv;
+	int count = 0;
+
+	for (kv = b->head; kv != NULL; kv = kv->next)
+	{
+		count++;
+	}
+
+	return count;
+}
+
+int bundle_get_type(bundle *b, const char *key)
+{
+	struct keyval_t *kv = b != NULL && key != NULL ? bundle_find(b, key) : NULL;
+
+	if (kv == NULL)
+	{
+		errno = ENOKEY;
+		return BUNDLE_TYPE_NONE;
+	}
+
+	return kv->type;
+}
+
+void bundle_foreach(bundle *b, bundle_iterator_t iter, void *user_data)
+{
+	struct keyval_t *kv;
+	struct keyval_t *next;
+
+	if (b == NULL || iter == NULL)
+	{
+		return;
+	}
+
+	for (kv = b->head; kv != NULL; kv = next)
+	{
+		next = kv->next;
+		iter(kv->key, kv->type, kv, user_data);
+	}
+}
+
+int bundle_keyval_get_type(bundle_keyval_t *kv)
+{
+	return kv->type;
+}
+
+int bundle_keyval_type_is_array(bundle_keyval_t *kv)
+{
+	return (kv->type & BUNDLE_TYPE_ARRAY) != 0;
+}
+
+int bundle_keyval_get_basic_val(bundle_keyval_t *kv, void **val, size_t *size)
+{
+	*val = kv->val;
+
+	if (size != NULL)
+	{
+		*size = kv->size;
+	}
+
+	return 0;
+}
+
+int bundle_keyval_get_array_val(bundle_keyval_t *kv, void ***array_val, unsigned int *array_len, size_t **array_element_size)
+{
+	*array_val = kv->array;
+	*array_len = kv->array_len;
+
+	if (array_element_size != NULL)
+	{
+		*array_element_size = kv->array_element_size;
+	}
+
+	return 0;
+}
+
+bundle* bundle_dup(bundle *b_from)
+{
+	struct keyval_t *kv;
+	bundle *b;
+
+	if (b_from == NULL)
+	{
+		errno = EINVAL;
+		return NULL;
+	}
+
+	b = bundle_create();
+
+	for (kv = b_from->head; kv != NULL; kv = kv->next)
+	{
+		if (kv->type & BUNDLE_TYPE_ARRAY)
+		{
+			bundle_add_array(b, kv->key, kv->type, (const void **)kv->array, kv->array_element_size, kv->array_len);
+		}
+		else if (kv->type == BUNDLE_TYPE_BYTE)
+		{
+			bundle_add_byte(b, kv->key, kv->val, kv->size);
+		}
+		else
+		{
+			bundle_add(b, kv->key, kv->val);
+		}
+	}
+
+	return b;
+}
+
+// the raw layout follows the platform bundle: every keyval is its total size,
+// the type, the key and the value, and the whole buffer is encoded in base64
+static const char bundle_base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static size_t bundle_keyval_raw_size(struct keyval_t *kv)
+{
+	size_t size = sizeof(size_t) + sizeof(int) + sizeof(size_t) + strlen(kv->key) + 1;
+	unsigned int i;
+
+	if (kv->type & BUNDLE_TYPE_ARRAY)
+	{
+		size += sizeof(unsigned int) + sizeof(size_t) + kv->array_len * sizeof(size_t);
+
+		for (i = 0; i < kv->array_len; i++)
+		{
+			size += kv->array_element_size[i];
+		}
+	}
+	else
+	{
+		size += sizeof(size_t) + kv->size;
+	}
+
+	return size;
+}
+
+static unsigned char *bundle_raw_put(unsigned char *p, const void *data, size_t size)
+{
+	memcpy(p, data, size);
+
+	return p + size;
+}
+
+int bundle_encode(bundle *b, bundle_raw **r, int *len)
+{
+	struct keyval_t *kv;
+	unsigned char *raw;
+	unsigned char *p;
+	unsigned char *out;
+	size_t raw_size = 0;
+	size_t kv_size;
+	size_t key_size;
+	size_t values_size;
+	size_t i;
+	size_t o;
+	unsigned int n;
+
+	if (b == NULL || r == NULL || len == NULL)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (kv = b->head; kv != NULL; kv = kv->next)
+	{
+		raw_size += bundle_keyval_raw_size(kv);
+	}
+
+	raw = malloc(raw_size > 0 ? raw_size : 1);
+
+	if (raw == NULL)
+	{
+		errno = ENOMEM;
+		return -1;
+	}
+
+	p = raw;
+
+	for (kv = b->head; kv != NULL; kv = kv->next)
+	{
+		kv_size = bundle_keyval_raw_size(kv);
+		key_size = strlen(kv->key) + 1;
+
+		p = bundle_raw_put(p, &kv_size, sizeof(size_t));
+		p = bundle_raw_put(p, &kv->type, sizeof(int));
+		p = bundle_raw_put(p, &key_size, sizeof(size_t));
+		p = bundle_raw_put(p, kv->key, key_size);
+
+		if (kv->type & BUNDLE_TYPE_ARRAY)
+		{
+			values_size = 0;
+
+			for (n = 0; n < kv->array_len; n++)
+			{
+				values_size += kv->array_element_size[n];
+			}
+
+			p = bundle_raw_put(p, &kv->array_len, sizeof(unsigned int));
+			p = bundle_raw_put(p, &values_size, sizeof(size_t));
+			p = bundle_raw_put(p, kv->array_element_size, kv->array_len * sizeof(size_t));
+
+			for (n = 0; n < kv->array_len; n++)
+			{
+				p = bundle_raw_put(p, kv->array[n], kv->array_element_size[n]);
+			}
+		}
+		else
+		{
+			p = bundle_raw_put(p, &kv->size, sizeof(size_t));
+			p = bundle_raw_put(p, kv->val, kv->size);
+		}
+	}
+
+	out = malloc((raw_size + 2) / 3 * 4 + 1);
+
+	if (out == NULL)
+	{
+		free(raw);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (i = 0, o = 0; i < raw_size; i += 3)
+	{
+		unsigned int triple = raw[i] << 16;
+
+		triple |= (i + 1 < raw_size ? raw[i + 1] : 0) << 8;
+		triple |= (i + 2 < raw_size ? raw[i + 2] : 0);
+
+		out[o++] = bundle_base64_table[(triple >> 18) & 0x3f];
+		out[o++] = bundle_base64_table[(triple >> 12) & 0x3f];
+		out[o++] = i + 1 < raw_size ? bundle_base64_table[(triple >> 6) & 0x3f] : '=';
+		out[o++] = i + 2 < raw_size ? bundle_base64_table[triple & 0x3f] : '=';
+	}
+
+	out[o] = '\0';
+	free(raw);
+
+	*r = out;
+	*len = o;
+
+	return 0;
+}
+
+static int bundle_base64_value(unsigned char c)
+{
+	if (c >= 'A' && c <= 'Z')
+	{
+		return c - 'A';
+	}
+
+	if (c >= 'a' && c <= 'z')
+	{
+		return c - 'a' + 26;
+	}
+
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0' + 52;
+	}
+
+	if (c == '+')
+	{
+		return 62;
+	}
+
+	return c == '/' ? 63 : -1;
+}
+
+bundle* bundle_decode(const bundle_raw *r, const int len)
+{
+	unsigned char *raw;
+	const unsigned char *p;
+	const unsigned char *end;
+	const unsigned char *values;
+	size_t *sizes;
+	size_t raw_size = 0;
+	size_t kv_size;
+	size_t key_size;
+	size_t val_size;
+	const char *key;
+	const void **array;
+	bundle *b;
+	int type;
+	int i;
+	int v;
+	unsigned int n;
+	unsigned int array_len;
+
+	if (r == NULL || len < 0 || len % 4 != 0)
+	{
+		errno = EINVAL;
+		return NULL;
+	}
+
+	raw = malloc(len / 4 * 3 + 1);
+	b = bundle_create();
+
+	if (raw == NULL || b == NULL)
+	{
+		free(raw);
+		free(b);
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	for (i = 0; i < len; i += 4)
+	{
+		unsigned int quad = 0;
+		int pad = 0;
+
+		for (v = 0; v < 4; v++)
+		{
+			int value = bundle_base64_value(r[i + v]);
+
+			if (value < 0)
+			{
+				pad++;
+				value = 0;
+			}
+
+			quad = (quad << 6) | value;
+		}
+
+		raw[raw_size++] = quad >> 16;
+
+		if (pad < 2)
+		{
+			raw[raw_size++] = (quad >> 8) & 0xff;
+		}
+
+		if (pad < 1)
+		{
+			raw[raw_size++] = quad & 0xff;
+		}
+	}
+
+	end = raw + raw_size;
+
+	for (p = raw; p + sizeof(size_t) <= end; p += kv_size)
+	{
+		memcpy(&kv_size, p, sizeof(size_t));
+		memcpy(&type, p + sizeof(size_t), sizeof(int));
+		memcpy(&key_size, p + sizeof(size_t) + sizeof(int), sizeof(size_t));
+
+		if (kv_size == 0 || kv_size > (size_t)(end - p))
+		{
+			break;
+		}
+
+		key = (const char *)p + sizeof(size_t) + sizeof(int) + sizeof(size_t);
+		values = (const unsigned char *)key + key_size;
+
+		if (type & BUNDLE_TYPE_ARRAY)
+		{
+			memcpy(&array_len, values, sizeof(unsigned int));
+			values += sizeof(unsigned int) + sizeof(size_t);
+
+			// the sizes are copied out since the raw buffer gives no alignment
+			array = calloc(array_len > 0 ? array_len : 1, sizeof(void *));
+			sizes = calloc(array_len > 0 ? array_len : 1, sizeof(size_t));
+
+			if (array != NULL && sizes != NULL)
+			{
+				memcpy(sizes, values, array_len * sizeof(size_t));
+				values += array_len * sizeof(size_t);
+
+				for (n = 0; n < array_len; n++)
+				{
+					array[n] = values;
+					values += sizes[n];
+				}
+
+				bundle_add_array(b, key, type, array, sizes, array_len);
+			}
+
+			free(array);
+			free(sizes);
+		}
+		else
+		{
+			memcpy(&val_size, values, sizeof(size_t));
+			values += sizeof(size_t);
+
+			if (type == BUNDLE_TYPE_BYTE)
+			{
+				bundle_add_byte(b, key, values, val_size);
+			}
+			else
+			{
+				bundle_add(b, key, (const char *)values);
+			}
+		}
+	}
+
+	free(raw);
+
+	return b;
+}
@@ -0,0 +1,23 @@
+/* Minimal stand-in for the platform header, only what the service benchmark needs */
+#ifndef STUB_ECORE_H
+#define STUB_ECORE_H
+typedef unsigned char Eina_Bool;
+#define EINA_TRUE 1
+#define EINA_FALSE 0
+#define ECORE_CALLBACK_CANCEL EINA_FALSE
+#define ECORE_CALLBACK_RENEW EINA_TRUE
+typedef struct _Ecore_Timer Ecore_Timer;
+typedef struct _Ecore_Job Ecore_Job;
+typedef struct _Ecore_Thread Ecore_Thread;
+typedef Eina_Bool (*Ecore_Task_Cb)(void *data);
+typedef void (*Ecore_Cb)(void *data);
+typedef void (*Ecore_Thread_Cb)(void *data, Ecore_Thread *thread);
+Ecore_Timer *ecore_timer_add(double in, Ecore_Task_Cb func, const void *data);
+void *ecore_timer_del(Ecore_Timer *timer);
+Ecore_Job *ecore_job_add(Ecore_Cb func, const void *data);
+Ecore_Thread *ecore_thread_run(Ecore_Thread_Cb func_blocking, Ecore_Thread_Cb func_end, Ecore_Thread_Cb func_cancel, const void *data);
+void ecore_main_loop_thread_safe_call_async(Ecore_Cb callback, void *data);
+
+/* stub only: runs and removes all the pending timers, returns the number of timers fired */
+int stub_ecore_timer_fire_all(void);
+#endif
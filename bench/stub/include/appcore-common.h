@@ -0,0 +1,7 @@
+/* Minimal stand-in for the platform header, only what the finalizer test needs */
+#ifndef STUB_APPCORE_COMMON_H
+#define STUB_APPCORE_COMMON_H
+#include <libintl.h>
+#define _(str) gettext(str)
+enum appcore_rm { APPCORE_RM_UNKNOWN, APPCORE_RM_PORTRAIT_NORMAL, APPCORE_RM_PORTRAIT_REVERSE, APPCORE_RM_LANDSCAPE_NORMAL, APPCORE_RM_LANDSCAPE_REVERSE };
+#endif
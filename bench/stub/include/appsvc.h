@@ -0,0 +1,31 @@
+/* Minimal stand-in for the platform header, only what the service benchmark needs */
+#ifndef STUB_APPSVC_H
+#define STUB_APPSVC_H
+#include <bundle.h>
+typedef enum { APPSVC_RES_OK = 0, APPSVC_RES_NOT_OK = -1, APPSVC_RES_CANCEL = -2 } appsvc_result_val;
+typedef void (*appsvc_res_fn)(bundle *b, int request_code, appsvc_result_val result, void *data);
+typedef int (*appsvc_info_iter_fn)(const char *pkg_name, void *data);
+int appsvc_set_operation(bundle *b, const char *operation);
+int appsvc_set_uri(bundle *b, const char *uri);
+int appsvc_set_mime(bundle *b, const char *mime);
+int appsvc_add_data(bundle *b, const char *key, const char *val);
+int appsvc_add_data_array(bundle *b, const char *key, const char **val_array, int len);
+int appsvc_set_pkgname(bundle *b, const char *pkg_name);
+const char *appsvc_get_operation(bundle *b);
+const char *appsvc_get_uri(bundle *b);
+const char *appsvc_get_mime(bundle *b);
+const char *appsvc_get_pkgname(bundle *b);
+const char *appsvc_get_data(bundle *b, const char *key);
+const char **appsvc_get_data_array(bundle *b, const char *key, int *len);
+int appsvc_data_is_array(bundle *b, const char *key);
+int appsvc_run_service(bundle *b, int request_code, appsvc_res_fn cbfunc, void *data);
+int appsvc_get_list(bundle *b, appsvc_info_iter_fn iter_fn, void *data);
+int appsvc_create_result_bundle(bundle *inb, bundle **outb);
+int appsvc_send_result(bundle *b, appsvc_result_val result);
+/* the bundle of the last appsvc_send_result(), owned by the stub */
+bundle *stub_appsvc_last_result(void);
+/* invokes the result callback of the last launch with the given reply */
+int stub_appsvc_deliver_result(bundle *b, appsvc_result_val result);
+/* makes appsvc_run_service() fail while set */
+void stub_appsvc_fail_launch(int fail);
+#endif
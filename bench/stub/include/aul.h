@@ -0,0 +1,10 @@
+/* Minimal stand-in for the platform header, only what the service benchmark needs */
+#ifndef STUB_AUL_H
+#define STUB_AUL_H
+#include <bundle.h>
+#define AUL_R_OK 0
+#define AUL_K_CALLER_PID "__AUL_CALLER_PID__"
+#define AUL_K_ORG_CALLER_PID "__AUL_ORG_CALLER_PID__"
+#define AUL_K_WAIT_RESULT "__AUL_WAIT_RESULT__"
+int aul_app_get_pkgname_bypid(int pid, char *pkgname, int len);
+#endif
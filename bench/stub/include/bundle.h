@@ -0,0 +1,32 @@
+/* Minimal stand-in for the platform header, only what the service benchmark needs */
+#ifndef STUB_BUNDLE_H
+#define STUB_BUNDLE_H
+#include <stddef.h>
+typedef struct _bundle_t bundle;
+typedef struct keyval_t bundle_keyval_t;
+typedef unsigned char bundle_raw;
+enum bundle_type_property { BUNDLE_TYPE_ARRAY = 0x0100, BUNDLE_TYPE_PRIMITIVE = 0x0200, BUNDLE_TYPE_MEASURABLE = 0x0400 };
+enum bundle_type { BUNDLE_TYPE_NONE = -1, BUNDLE_TYPE_ANY = 0, BUNDLE_TYPE_STR = 1 | BUNDLE_TYPE_MEASURABLE,
+	BUNDLE_TYPE_STR_ARRAY = BUNDLE_TYPE_STR | BUNDLE_TYPE_ARRAY | BUNDLE_TYPE_MEASURABLE,
+	BUNDLE_TYPE_BYTE = 2, BUNDLE_TYPE_BYTE_ARRAY = BUNDLE_TYPE_BYTE | BUNDLE_TYPE_ARRAY };
+typedef void (*bundle_iterator_t)(const char *key, const int type, const bundle_keyval_t *kv, void *user_data);
+bundle* bundle_create(void);
+int bundle_free(bundle *b);
+int bundle_add(bundle *b, const char *key, const char *val);
+int bundle_del(bundle *b, const char* key);
+const char* bundle_get_val(bundle *b, const char *key);
+int bundle_get_count(bundle *b);
+int bundle_get_type(bundle *b, const char *key);
+void bundle_foreach(bundle *b, bundle_iterator_t iter, void *user_data);
+int bundle_keyval_get_type(bundle_keyval_t *kv);
+int bundle_keyval_type_is_array(bundle_keyval_t *kv);
+int bundle_keyval_get_basic_val(bundle_keyval_t *kv, void **val, size_t *size);
+int bundle_keyval_get_array_val(bundle_keyval_t *kv, void ***array_val, unsigned int *array_len, size_t **array_element_size);
+bundle* bundle_dup(bundle *b_from);
+int bundle_add_str_array(bundle *b, const char *key, const char **str_array, const int len);
+const char** bundle_get_str_array(bundle *b, const char *key, int *len);
+int bundle_add_byte(bundle *b, const char *key, const void *byte, const size_t size);
+int bundle_get_byte(bundle *b, const char *key, void **byte, size_t *size);
+int bundle_encode(bundle *b, bundle_raw **r, int *len);
+bundle* bundle_decode(const bundle_raw *r, const int len);
+#endif
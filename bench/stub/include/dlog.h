@@ -0,0 +1,9 @@
+/* Minimal stand-in for the platform header, only what the service benchmark needs */
+#ifndef STUB_DLOG_H
+#define STUB_DLOG_H
+#include <stdio.h>
+#define LOGE(fmt, ...) fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+#define LOGW(fmt, ...) fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+#define LOGI(fmt, ...) do { if (0) fprintf(stderr, fmt "\n", ##__VA_ARGS__); } while (0)
+#define LOGD(fmt, ...) do { if (0) fprintf(stderr, fmt "\n", ##__VA_ARGS__); } while (0)
+#endif
@@ -0,0 +1,24 @@
+/* Minimal stand-in for the platform header, only what the service benchmark needs */
+#ifndef STUB_TIZEN_H
+#define STUB_TIZEN_H
+#include <stdbool.h>
+#include <errno.h>
+#define TIZEN_ERROR_NONE 0
+#define TIZEN_ERROR_INVALID_PARAMETER (-EINVAL)
+#define TIZEN_ERROR_OUT_OF_MEMORY (-ENOMEM)
+#define TIZEN_ERROR_NOT_PERMITTED (-EPERM)
+#define TIZEN_ERROR_NO_SUCH_FILE (-ENOENT)
+#define TIZEN_ERROR_ALREADY_IN_PROGRESS (-EALREADY)
+#define TIZEN_ERROR_APPLICATION_CLASS (-0x00400000)
+#define TIZEN_ERROR_KEY_NOT_AVAILABLE (-ENOKEY)
+#define TIZEN_ERROR_KEY_REJECTED (-EKEYREJECTED)
+#define TIZEN_ERROR_IO_ERROR (-EIO)
+#define TIZEN_ERROR_TIMED_OUT (-ETIMEDOUT)
+#define TIZEN_ERROR_RESOURCE_BUSY (-EBUSY)
+#define TIZEN_ERROR_NOT_SUPPORTED (-ENOTSUP)
+#define TIZEN_ERROR_PERMISSION_DENIED (-EACCES)
+#define TIZEN_ERROR_NO_SUCH_DEVICE (-ENODEV)
+#define TIZEN_ERROR_DB_FAILED (-0x00010000)
+#define TIZEN_ERROR_INVALID_OPERATION (-ENOSYS)
+#define TIZEN_ERROR_UNKNOWN (-0x7fffffff)
+#endif
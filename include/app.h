@@ -18,6 +18,7 @@
 #ifndef __TIZEN_APPFW_APP_H__
 #define __TIZEN_APPFW_APP_H__
 
+#include <time.h>
 #include <tizen.h>
 #include <app_service.h>
 #include <app_alarm.h>
@@ -50,6 +51,38 @@ typedef enum
 } app_error_e;
 
 
+/**
+ * @brief Enumerations of the hints on how the mapped resource is accessed.
+ */
+typedef enum
+{
+	APP_RESOURCE_MAP_HINT_NONE = 0x00, /**< No hint */
+	APP_RESOURCE_MAP_HINT_SEQUENTIAL = 0x01, /**< The resource is read sequentially, so it can be read ahead aggressively */
+	APP_RESOURCE_MAP_HINT_WILLNEED = 0x02, /**< The resource will be read soon, so it can be read ahead now */
+} app_resource_map_hint_e;
+
+
+/**
+ * @brief The handle to the read-only mapping of a resource.
+ */
+typedef struct app_resource_map_s *app_resource_map_h;
+
+
+/**
+ * @brief Enumerations of the phases of the application startup.
+ */
+typedef enum
+{
+	APP_STARTUP_PHASE_GET_PACKAGE = 0, /**< Getting the package of the application from the launch system */
+	APP_STARTUP_PHASE_GET_APP_NAME, /**< Getting the name of the application from the package information */
+	APP_STARTUP_PHASE_APPCORE_INIT, /**< Initializing the application framework until the creation of the application */
+	APP_STARTUP_PHASE_LOCALE_PROBE, /**< Looking up the locale directory of the application */
+	APP_STARTUP_PHASE_I18N, /**< Setting up the localization of the application */
+	APP_STARTUP_PHASE_CREATE_CB, /**< Running app_create_cb() */
+	APP_STARTUP_PHASE_MAX, /**< The number of the phases */
+} app_startup_phase_e;
+
+
 /**
  * @brief Enumerations of the device orientation.
  */
@@ -197,6 +230,9 @@ typedef void (*app_region_format_changed_cb) (void *user_data);
 /**
  * @brief The structure type to contain the set of callback functions for handling application events. 
  * @details It is one of the input parameters of the app_efl_main() function.
+ * @remarks The low memory callback is called as soon as the event arrives.
+ * The low battery, device orientation, language and region format callbacks are called later from the main loop,
+ * and the events of the same type that arrive in the meantime are delivered once. Only the last orientation is delivered.
  *
  * @see app_efl_main()
  * @see app_create_cb()
@@ -338,6 +374,46 @@ int app_get_name(char **name);
 int app_get_version(char **version);
 
 
+/**
+ * @brief Gets the ID of the application without copying it.
+ *
+ * @remarks The returned string is owned by the framework and must not be released.
+ * It is valid for the lifetime of the process.
+ *
+ * @return The ID of the application, or @c NULL if the application is illegally launched
+ * @see app_get_id()
+ */
+const char* app_peek_id(void);
+
+
+/**
+ * @brief Gets the localized name of the application without copying it.
+ *
+ * @details The application information is queried once and cached for the process.
+ * The cache is refreshed when the language of the device changes.
+ *
+ * @remarks The returned string is owned by the framework and must not be released.
+ * It is valid for the lifetime of the process, also after the language of the device changes.
+ *
+ * @return The name of the application, or @c NULL on failure
+ * @see app_get_name()
+ * @see app_language_changed_cb()
+ */
+const char* app_peek_name(void);
+
+
+/**
+ * @brief Gets the version of the application package without copying it.
+ *
+ * @remarks The returned string is owned by the framework and must not be released.
+ * It is valid for the lifetime of the process, also after the language of the device changes.
+ *
+ * @return The version of the application, or @c NULL on failure
+ * @see app_get_version()
+ */
+const char* app_peek_version(void);
+
+
 /**
  * @brief Gets the absolute path to the resource included in application package
  *
@@ -354,6 +430,138 @@ int app_get_version(char **version);
 char* app_get_resource(const char *resource, char *buffer, int size);
 
 
+/**
+ * @brief Maps the resource included in application package into memory for reading.
+ *
+ * @details The resource is mapped read-only without copying it into the heap.
+ * If the resource is already mapped, the mapping is shared and its reference count is increased.
+ *
+ * @remarks The @a map must be released with app_resource_unmap() by you.
+ *
+ * @param [in] resource The resource's path relative to the resource directory of the application package (e.g. edje/app.edj or images/background.png)
+ * @param [in] hints The bitwise OR of #app_resource_map_hint_e values
+ * @param [out] map The handle to the mapping
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter, or the path goes out of the resource directory
+ * @retval #APP_ERROR_INVALID_CONTEXT The resource directory cannot be found
+ * @retval #APP_ERROR_NO_SUCH_FILE The resource does not exist
+ * @retval #APP_ERROR_OUT_OF_MEMORY Out of memory
+ * @see app_resource_map_get_data()
+ * @see app_resource_unmap()
+ */
+int app_resource_map(const char *resource, int hints, app_resource_map_h *map);
+
+
+/**
+ * @brief Gets the contents of the mapped resource.
+ *
+ * @remarks @a data is valid until the mapping is released. @a data is NULL if the resource is empty.
+ *
+ * @param [in] map The handle to the mapping
+ * @param [out] data The contents of the resource
+ * @param [out] size The size of the resource in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see app_resource_map()
+ */
+int app_resource_map_get_data(app_resource_map_h map, const void **data, size_t *size);
+
+
+/**
+ * @brief Releases the mapping of the resource.
+ *
+ * @details The resource is unmapped when all references to the mapping are released.
+ *
+ * @param [in] map The handle to the mapping
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see app_resource_map()
+ */
+int app_resource_unmap(app_resource_map_h map);
+
+
+/**
+ * @brief Sets the duration in which the resources used by the application are recorded to be prefetched on the next launch.
+ *
+ * @details If the duration is set, the resources looked up by app_get_resource() during the given seconds after the launch
+ * are saved in the application's data directory. On the next launch, those resources are read ahead into the page cache
+ * by a background thread while the application starts up.
+ *
+ * @remarks The prefetching is disabled by default. This function must be called before app_efl_main().
+ *
+ * @param [in] duration The duration of the recording in seconds, or 0 to disable the prefetching
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see app_get_resource()
+ */
+int app_set_resource_prefetch(int duration);
+
+
+/**
+ * @brief Loads the index of the resources included in application package.
+ *
+ * @details The resource directory is scanned once, and the paths and the sizes of all resources are kept in memory,
+ * so app_resource_exists() and app_resource_get_size() do not need any system call per resource.
+ * If the resource index cache is enabled, the index is loaded from the cache in the application's data directory
+ * as long as the package has not been installed again and no resource has been added, removed or renamed since the cache was written.
+ * A resource which is rewritten in place by other means than installing the package is not detected.
+ * The symbolic links are indexed as the files or directories they point to, but the directories they point to are not scanned.
+ *
+ * @remarks The index is loaded by app_resource_exists() or app_resource_get_size() if it is not loaded yet.
+ * The index is not updated when the resource directory changes while the application is running.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_CONTEXT The resource directory cannot be scanned
+ * @see app_set_resource_index_cache()
+ */
+int app_resource_index_load(void);
+
+
+/**
+ * @brief Checks whether the resource exists in application package.
+ *
+ * @param [in] resource The resource's path relative to the resource directory of the application package (e.g. edje/app.edj or images/background.png)
+ * @param [out] exists @c true if the resource is a file in the resource directory, otherwise @c false
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #APP_ERROR_INVALID_CONTEXT The resource directory cannot be scanned
+ * @see app_resource_index_load()
+ */
+int app_resource_exists(const char *resource, bool *exists);
+
+
+/**
+ * @brief Gets the size of the resource in application package.
+ *
+ * @param [in] resource The resource's path relative to the resource directory of the application package (e.g. edje/app.edj or images/background.png)
+ * @param [out] size The size of the resource in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #APP_ERROR_INVALID_CONTEXT The resource directory cannot be scanned
+ * @retval #APP_ERROR_NO_SUCH_FILE The resource does not exist
+ * @see app_resource_index_load()
+ */
+int app_resource_get_size(const char *resource, size_t *size);
+
+
+/**
+ * @brief Sets whether the resource index is cached in the application's data directory.
+ *
+ * @remarks The resource index cache is disabled by default. This function must be called before the index is loaded.
+ *
+ * @param [in] enable Whether the resource index is cached
+ * @see app_resource_index_load()
+ */
+void app_set_resource_index_cache(bool enable);
+
+
 /**
  * @brief Gets the absolute path to the application's data directory.
  *
@@ -389,6 +597,92 @@ app_device_orientation_e app_get_device_orientation(void);
 void app_set_reclaiming_system_cache_on_pause(bool enable);
 
 
+/**
+ * @brief Sets whether the caches of the application framework are released in the pause state.
+ *
+ * @details The application framework caches the lookups of the service API, the resource index and the spare service handles.
+ * These caches are always released when the system is low on memory, before app_low_memory_cb() is called.
+ * If this option is enabled, they are also released when the application's state changes to the pause state,
+ * at the cost of rebuilding them after the application is resumed.
+ *
+ * @remarks The option is disabled by default.
+ *
+ * @param [in] enable Whether the caches are released in the pause state
+ * @see app_set_reclaiming_system_cache_on_pause()
+ */
+void app_set_reclaiming_cache_on_pause(bool enable);
+
+
+/**
+ * @brief Sets the time budget of the clean-up of the framework when the application is terminated.
+ *
+ * @details The framework releases its resources after app_terminate_cb() returns.
+ * Once the budget is spent, the remaining clean-up is skipped and left to the system, except for the steps which save data.
+ *
+ * @remarks The budget is unlimited by default.
+ *
+ * @param [in] budget The time budget in milliseconds, or @c 0 for no limit
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see app_terminate_cb()
+ */
+int app_set_shutdown_time_budget(int budget);
+
+
+/**
+ * @brief Sets whether the localization of the application is set up lazily.
+ *
+ * @details If the lazy setup is enabled, the locale directory of the application is looked up and bound
+ * on the first call to i18n_get_text() or when the main loop becomes idle for the first time, whichever comes first,
+ * instead of before app_create_cb() is called.
+ *
+ * @remarks The lazy setup is disabled by default. This function must be called before app_efl_main().
+ *
+ * @param [in] enable Whether the localization is set up lazily
+ * @see i18n_get_text()
+ */
+void app_set_deferred_i18n(bool enable);
+
+
+/**
+ * @brief Gets the time when the given phase of the application startup begins and ends.
+ *
+ * @details The times are read from CLOCK_MONOTONIC.
+ * @remarks If the environment variable CAPI_APPFW_STARTUP_PROFILE is set to 1,
+ * the durations of all phases are written to the system log after app_create_cb() returns.
+ *
+ * @param [in] phase The phase of the application startup
+ * @param [out] begin The time when the phase begins
+ * @param [out] end The time when the phase ends
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #APP_ERROR_INVALID_CONTEXT The phase has not been completed
+ */
+int app_get_startup_phase(app_startup_phase_e phase, struct timespec *begin, struct timespec *end);
+
+
+/**
+ * @brief Sets the window in which identical launch requests are coalesced.
+ *
+ * @details If the window is set, a launch request is dropped without invoking app_service_cb()
+ * when it has the same operation, URI, MIME type, caller and extra data as the last dispatched request,
+ * and it arrives within the window after the last dispatched request.
+ * The launch requests for which the caller waits for the reply,
+ * or which carry extra data in shared memory, are never coalesced.
+ *
+ * @remarks The coalescing is disabled by default.
+ *
+ * @param [in] window The coalescing window in milliseconds, or 0 to disable the coalescing
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #APP_ERROR_NONE Successful
+ * @retval #APP_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see app_service_cb()
+ */
+int app_set_service_coalescing_window(int window);
+
+
 /**
  * @}
  */
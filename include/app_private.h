@@ -42,20 +42,76 @@ extern "C" {
 #define PATH_FMT_RO_RES_DIR PATH_FMT_RO_APP_ROOT "/%s/res"
 #define PATH_FMT_RO_LOCALE_DIR PATH_FMT_RO_RES_DIR "/locale"
 
+typedef enum {
+	APP_PATH_ROOT,
+	APP_PATH_BIN,
+	APP_PATH_RES,
+	APP_PATH_DATA,
+	APP_PATH_LOCALE,
+	APP_PATH_MAX,
+} app_path_type_e;
+
 typedef void (*app_finalizer_cb) (void *data);
 
+/* the finalizers run in this order, the ones registered with the same priority in the registration order */
+typedef enum {
+	APP_FINALIZER_PRIORITY_CRITICAL, /* completes the writes of persistent data, such as closing the preference database, never skipped */
+	APP_FINALIZER_PRIORITY_DEFAULT,
+	APP_FINALIZER_PRIORITY_LOW, /* releases what the system reclaims at exit anyway */
+	APP_FINALIZER_PRIORITY_MAX,
+} app_finalizer_priority_e;
+
+typedef void (*app_i18n_init_cb) (void *data);
+
+/* returns the number of bytes released */
+typedef size_t (*app_reclaimer_cb) (void *data);
+
 int app_error(app_error_e error, const char* function, const char *description);
 
 app_device_orientation_e app_convert_appcore_rm(enum appcore_rm rm);
 
 int app_get_package_app_name(const char *package, char **name);
 
+/* the returned path is resolved by the first successful call and must not be freed */
+const char* app_get_path(app_path_type_e type);
+
 int app_finalizer_add(app_finalizer_cb callback, void *data);
 
+int app_finalizer_add_with_priority(app_finalizer_cb callback, void *data, app_finalizer_priority_e priority);
+
 int app_finalizer_remove(app_finalizer_cb callback);
 
 void app_finalizer_execute(void);
 
+int app_reclaimer_add(app_reclaimer_cb callback, void *data);
+
+int app_reclaimer_remove(app_reclaimer_cb callback);
+
+size_t app_reclaimer_execute(void);
+
+bool app_reclaimer_is_enabled_on_pause(void);
+
+void app_startup_phase_begin(app_startup_phase_e phase);
+
+void app_startup_phase_end(app_startup_phase_e phase);
+
+void app_startup_dump(void);
+
+void app_i18n_defer_init(app_i18n_init_cb callback, void *data);
+
+void app_i18n_run_pending_init(void);
+
+/* returns the number of bytes released */
+size_t app_resource_index_release(void);
+
+void app_prefetch_start(void);
+
+void app_prefetch_schedule_stop(void);
+
+void app_prefetch_stop(void);
+
+void app_prefetch_record(const char *resource);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,6 +19,7 @@
 #define __TIZEN_APPFW_SERVICE_H__
 
 #include <sys/types.h>
+#include <time.h>
 #include <tizen.h>
 
 #ifdef __cplusplus
@@ -33,10 +34,25 @@ extern "C" {
 
 /**
  * @brief Service handle.
+ *
+ * @details Service handles can be created, cloned and destroyed from any thread. \n
+ * Different service handles can be used concurrently from different threads.
+ * A single service handle is not synchronized, so it must not be modified or destroyed while another thread is using it.
+ * Cloning the same handle from several threads at once is safe as long as no thread modifies it.
  */
 typedef struct service_s *service_h;
 
 
+/**
+ * @brief Service builder handle.
+ *
+ * @details The service builder accumulates the fields of a launch request in a preallocated buffer,
+ * and creates the service handle at once. A single service builder is not synchronized.
+ * @see service_builder_create()
+ */
+typedef struct service_builder_s *service_builder_h;
+
+
 /**
  * @brief Enumerations of error code for Service.
  */
@@ -181,6 +197,22 @@ typedef enum
 typedef void (*service_reply_cb) (service_h request, service_h reply, service_result_e result, void *user_data);
 
 
+/**
+ * @brief   Called when the asynchronous launch request has been processed by the launch system.
+ *
+ * @remarks The @a request must not be deallocated by an application.
+ *
+ * @param   [in] request The service handle of the launch request that has sent
+ * @param   [in] request_id The ID of the launch request returned by service_send_launch_request_async()
+ * @param   [in] pid The process ID of the callee on success, otherwise a negative value
+ * @param   [in] error #SERVICE_ERROR_NONE on success, otherwise #SERVICE_ERROR_APP_NOT_FOUND
+ * @param   [in] user_data	The user data passed from the callback registration function
+ * @pre service_send_launch_request_async() will invoke this callback on the main loop.
+ * @see service_send_launch_request_async()
+ */
+typedef void (*service_launch_cb) (service_h request, int request_id, int pid, service_error_e error, void *user_data);
+
+
 /**
 * @brief   Called to retrieve the extra data that are contained in the service
 *
@@ -213,6 +245,7 @@ typedef bool (*service_app_matched_cb)(service_h service, const char *package, v
  * @brief Creates a service handle.
  *
  * @remarks The @a service must be released with service_destroy() by you. 
+ * @remarks This function is thread-safe.
  * @param [out] service A service handle to be newly created on success
  * @return 0 on success, otherwise a negative error value.
  * @retval #SERVICE_ERROR_NONE Successful
@@ -226,6 +259,7 @@ int service_create(service_h *service);
 /**
  * @brief Destroys the service handle and releases all its resources.
  *
+ * @remarks This function is thread-safe, but the @a service must not be in use by another thread.
  * @param [in] service The service handle
  * @return 0 on success, otherwise a negative error value.
  * @retval #SERVICE_ERROR_NONE Successful
@@ -467,6 +501,112 @@ int service_add_extra_data(service_h service, const char *key, const char *value
 int service_add_extra_data_array(service_h service, const char *key, const char* value[], int length);
 
 
+/**
+ * @brief Adds the extra data of the byte array to the service.
+ *
+ * @details The byte array is delivered as it is, without being encoded into a string.
+ * @remarks The function replaces any existing value for the given key.
+ * @remarks The function returns #SERVICE_ERROR_INVALID_PARAMETER if key is zero-length string or @a size is 0.
+ * @remarks The function returns #SERVICE_ERROR_KEY_REJECTED if the application tries to use same key with system-defined key
+ * @param [in] service The service handle
+ * @param [in] key The name of the extra data
+ * @param [in] value The byte array associated with given key
+ * @param [in] size The size of the byte array in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_KEY_REJECTED Not available key
+ * @see service_get_extra_data_byte()
+ * @see service_is_extra_data_byte()
+ * @see service_remove_extra_data()
+ */
+int service_add_extra_data_byte(service_h service, const char *key, const void *value, size_t size);
+
+
+/**
+ * @brief Gets the extra data of the byte array from the service.
+ *
+ * @remarks The @a value must be released with free() by you.
+ * @remarks The function returns #SERVICE_ERROR_INVALID_DATA_TYPE if the value is not the byte array.
+ * @param [in] service The service handle
+ * @param [in] key The name of the extra data
+ * @param [out] value The byte array associated with given key
+ * @param [out] size The size of the byte array in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_KEY_NOT_FOUND Specified key not found
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SERVICE_ERROR_INVALID_DATA_TYPE Invalid data type
+ * @see service_add_extra_data_byte()
+ * @see service_foreach_extra_data()
+ */
+int service_get_extra_data_byte(service_h service, const char *key, void **value, size_t *size);
+
+
+/**
+ * @brief Checks whether if the extra data associated with given @a key is the byte array.
+ *
+ * @param [in] service The service handle
+ * @param [in] key The name of the extra data
+ * @param [out] byte @c True if the extra data is the byte array, otherwise @c false
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see service_add_extra_data_byte()
+ * @see service_get_extra_data_byte()
+ */
+int service_is_extra_data_byte(service_h service, const char *key, bool *byte);
+
+
+/**
+ * @brief Attaches a large payload to the service through shared memory.
+ *
+ * @details The payload is copied once into a shared memory segment and only the reference to the segment is contained in the service,
+ * so the payload is not serialized when the launch request is delivered.
+ * The callee maps the payload with service_get_extra_data_shm() without copying it.
+ * A payload attached to a reply is delivered to the caller with service_reply_to_launch_request() the same way.
+ * @remarks The function replaces any existing payload for the given key.
+ * @remarks The payload can be mapped only by the applications running as the same user.
+ * @remarks The payload is shared by the clones of the @a service. It is released when the callee maps it,
+ * or when it has been removed from or destroyed with the @a service and all its clones, if it has not been sent.
+ * Once sent, it is released 60 seconds after the last handle referring to it is destroyed, or when the caller exits, whichever comes first.
+ * @remarks The payload is not retrieved by service_foreach_extra_data().
+ * @param [in] service The service handle
+ * @param [in] key The name of the payload
+ * @param [in] value The payload
+ * @param [in] size The size of the payload in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_KEY_REJECTED Not available key
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Failed to allocate the shared memory
+ * @see service_get_extra_data_shm()
+ * @see service_remove_extra_data()
+ */
+int service_add_extra_data_shm(service_h service, const char *key, const void *value, size_t size);
+
+
+/**
+ * @brief Maps the payload attached through shared memory to the service.
+ *
+ * @remarks The @a value is read-only and must not be released by you. It is unmapped when the @a service is destroyed.
+ * @remarks The payload can be mapped by only one launch request received, since it is released once it is mapped.
+ * @param [in] service The service handle
+ * @param [in] key The name of the payload
+ * @param [out] value The payload
+ * @param [out] size The size of the payload in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_KEY_NOT_FOUND Specified key not found, or the payload has been released
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SERVICE_ERROR_INVALID_DATA_TYPE Invalid data type
+ * @see service_add_extra_data_shm()
+ */
+int service_get_extra_data_shm(service_h service, const char *key, const void **value, size_t *size);
+
+
 /**
  * @brief Removes the extra data from the service.
  *
@@ -584,6 +724,9 @@ int service_foreach_app_matched(service_h service, service_app_matched_cb callba
  * @details The operation is mandatory information for the launch request. \n
  * If the operation is not specified, #SERVICE_OPERATION_DEFAULT is used by default.
  * If the operation is #SERVICE_OPERATION_DEFAULT, the application ID is mandatory to explicitly launch the application
+ * @remarks If the application sends the launch request to itself without @a callback,
+ * the launch request is delivered to its app_service_cb() from the main loop after this function returns, without going through the launch system.
+ * The launch requests sent before app_create_cb() returns are delivered once the application is running.
  * @param [in] service The service handle
  * @param [in] callback The callback function to be called when the reply is delivered
  * @param [in] user_data The user data to be passed to the callback function
@@ -599,6 +742,76 @@ int service_foreach_app_matched(service_h service, service_app_matched_cb callba
 int service_send_launch_request(service_h service, service_reply_cb callback, void *user_data);
 
 
+/**
+ * @brief Sends the launch request without blocking the caller.
+ *
+ * @details This function returns immediately and the launch request is delivered to the launch system on a worker thread. \n
+ * The result of the launch is reported through service_launch_cb() on the main loop.
+ * If the launch request is sent for the result, it is delivered from the main loop instead, since the launch system registers the reply there,
+ * and the reply is delivered through service_reply_cb() as service_send_launch_request() does.
+ * @remarks The @a service can be modified or destroyed after this function returns.
+ * @param [in] service The service handle
+ * @param [in] launch_cb The callback function to be called when the launch request has been processed
+ * @param [in] reply_cb The callback function to be called when the reply is delivered
+ * @param [in] user_data The user data to be passed to the callback functions
+ * @param [out] request_id The ID of the launch request, which is also passed to service_launch_cb()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SERVICE_ERROR_APP_NOT_FOUND The application ID is not specified with the default operation
+ * @post service_launch_cb() is invoked when the launch request has been processed.
+ * @see service_send_launch_request()
+ * @see service_launch_cb()
+ * @see service_reply_cb()
+ */
+int service_send_launch_request_async(service_h service, service_launch_cb launch_cb, service_reply_cb reply_cb, void *user_data, int *request_id);
+
+
+/**
+ * @brief Sets the time to wait for the reply to a launch request.
+ *
+ * @details If the callee does not reply within the given time, service_reply_cb() is invoked with #SERVICE_RESULT_FAILED and an empty reply,
+ * and a reply delivered after that is discarded.
+ * @remarks The timeout applies to the launch requests sent after this function is called.
+ * @remarks The timeout is disabled by default.
+ * @param [in] timeout The timeout in milliseconds, or 0 to wait for the reply without time limit
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see service_send_launch_request()
+ * @see service_expire_launch_requests()
+ */
+int service_set_launch_request_timeout(int timeout);
+
+
+/**
+ * @brief Cancels the launch request waiting for the reply.
+ *
+ * @details service_reply_cb() is invoked immediately with #SERVICE_RESULT_CANCELED and an empty reply,
+ * and the reply from the callee is discarded.
+ * @param [in] request_id The ID of the launch request returned by service_send_launch_request_async()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER No launch request with the given ID is waiting for the reply
+ * @see service_send_launch_request_async()
+ */
+int service_cancel_launch_request(int request_id);
+
+
+/**
+ * @brief Expires all launch requests that have been waiting for the reply at least for the given time.
+ *
+ * @details service_reply_cb() is invoked with #SERVICE_RESULT_FAILED and an empty reply for each expired launch request.
+ * @param [in] age The time in milliseconds, or 0 to expire all launch requests waiting for the reply
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see service_set_launch_request_timeout()
+ */
+int service_expire_launch_requests(int age);
+
+
 /**
  * @brief Replies to the launch request that the caller sent
  * @details If the caller application sent the launch request to receive the result, the callee application can return the result back to the caller.
@@ -619,6 +832,7 @@ int service_reply_to_launch_request(service_h reply, service_h request, service_
  * @brief Creates and returns a copy of the given service handle.
  *
  * @remarks A newly created service should be destroyed by calling service_destroy() if it is no longer needed.
+ * @remarks This function is thread-safe, but the @a service must not be modified by another thread while it is cloned.
  *
  * @param [out] clone If successful, a newly created service handle will be returned.
  * @param [in] service The service handle
@@ -647,6 +861,25 @@ int service_clone(service_h *clone, service_h service);
 int service_get_caller(service_h service, char **id);
 
 
+/**
+ * @brief Gets the application ID of the caller from the launch request without copying it
+ *
+ * @details The application ID is resolved once per caller process and is shared by the following launch requests from the same caller.
+ * @remarks The @a service must be the launch request from app_service_cb().
+ * @remarks This function returns #SERVICE_ERROR_INVALID_PARAMETER if the given service is not the launch request.
+ * @remarks The @a id must not be released by you. It is valid until the @a service is destroyed.
+ * @param [in] service The service handle from app_service_cb()
+ * @param [out] id The application ID of the caller
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SERVICE_ERROR_APP_NOT_FOUND The caller application was not found
+ * @see service_get_caller()
+ */
+int service_peek_caller(service_h service, const char **id);
+
+
 /**
  * @brief Check whether the caller is requesting a reply from the launch reqeust
  *
@@ -661,6 +894,294 @@ int service_get_caller(service_h service, char **id);
  */
 int service_is_reply_requested(service_h service, bool *requested);
 
+
+/**
+ * @brief Encodes the service into the compact binary form to be persisted or transferred.
+ *
+ * @details The encoded data contains the operation, URI, MIME type, application ID and all extra data of the service.
+ * The encoding is versioned and uses the byte order of the host.
+ * The extra data added with service_add_extra_data_shm() and the launch data set by the platform are not encoded,
+ * since they only remain valid as long as the service handle does.
+ * @remarks If @a buffer is NULL, this function only stores the required size in bytes into @a length.
+ * @param [in] service The service handle
+ * @param [in] buffer The pre-allocated buffer where the encoded service is stored
+ * @param [in] size The size of @a buffer in bytes
+ * @param [out] length The size of the encoded service in bytes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter, or the buffer is not big enough
+ * @retval #SERVICE_ERROR_INVALID_DATA_TYPE The service contains data that cannot be encoded
+ * @see service_decode()
+ */
+int service_encode(service_h service, void *buffer, size_t size, size_t *length);
+
+
+/**
+ * @brief Creates a service handle from the data encoded by service_encode().
+ *
+ * @remarks The @a service must be released with service_destroy() by you.
+ * @param [in] buffer The encoded service
+ * @param [in] length The size of @a buffer in bytes
+ * @param [out] service A service handle to be newly created on success
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter, or the data is corrupted or carries data that service_encode() never encodes
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SERVICE_ERROR_INVALID_DATA_TYPE The data was encoded with unknown data type
+ * @see service_encode()
+ */
+int service_decode(const void *buffer, size_t length, service_h *service);
+
+/**
+ * @brief Creates a service builder with the capacity for the expected size of the launch request.
+ *
+ * @details The builder, its key table and its string buffer are allocated at once.
+ * The builder grows by doubling if the launch request exceeds the given capacity.
+ * @remarks The @a builder must be released with service_builder_destroy() by you.
+ * @param [in] key_count The expected number of extra data, or 0 to use the default capacity
+ * @param [in] size The expected total size in bytes of the strings including the terminating null characters, or 0 to use the default capacity
+ * @param [out] builder The service builder handle to be newly created on success
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_builder_destroy()
+ * @see service_builder_build()
+ */
+int service_builder_create(int key_count, size_t size, service_builder_h *builder);
+
+
+/**
+ * @brief Destroys the service builder and releases all its resources.
+ *
+ * @param [in] builder The service builder handle
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see service_builder_create()
+ */
+int service_builder_destroy(service_builder_h builder);
+
+
+/**
+ * @brief Sets the operation of the launch request to be built.
+ *
+ * @param [in] builder The service builder handle
+ * @param [in] operation The operation, or NULL to clear the previous value
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_set_operation()
+ */
+int service_builder_set_operation(service_builder_h builder, const char *operation);
+
+
+/**
+ * @brief Sets the URI of the data of the launch request to be built.
+ *
+ * @param [in] builder The service builder handle
+ * @param [in] uri The URI, or NULL to clear the previous value
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_set_uri()
+ */
+int service_builder_set_uri(service_builder_h builder, const char *uri);
+
+
+/**
+ * @brief Sets the MIME type of the data of the launch request to be built.
+ *
+ * @param [in] builder The service builder handle
+ * @param [in] mime The MIME type, or NULL to clear the previous value
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_set_mime()
+ */
+int service_builder_set_mime(service_builder_h builder, const char *mime);
+
+
+/**
+ * @brief Sets the ID of the application to explicitly launch.
+ *
+ * @param [in] builder The service builder handle
+ * @param [in] app_id The ID of the application, or NULL to clear the previous value
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_set_app_id()
+ */
+int service_builder_set_app_id(service_builder_h builder, const char *app_id);
+
+
+/**
+ * @brief Adds the extra data to the launch request to be built.
+ *
+ * @remarks If the key is added more than once, the last value is used.
+ * @param [in] builder The service builder handle
+ * @param [in] key The name of the extra data
+ * @param [in] value The value associated with given key
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_KEY_REJECTED Not available key
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_add_extra_data()
+ */
+int service_builder_add_extra_data(service_builder_h builder, const char *key, const char *value);
+
+
+/**
+ * @brief Adds the extra data array to the launch request to be built.
+ *
+ * @remarks If the key is added more than once, the last value is used.
+ * @param [in] builder The service builder handle
+ * @param [in] key The name of the extra data
+ * @param [in] value The array value associated with given key
+ * @param [in] length The length of the array
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_KEY_REJECTED Not available key
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_add_extra_data_array()
+ */
+int service_builder_add_extra_data_array(service_builder_h builder, const char *key, const char* value[], int length);
+
+
+/**
+ * @brief Creates a service handle from the fields accumulated in the service builder.
+ *
+ * @details The bundle of the service is filled in a single pass over the builder's buffer,
+ * without the per-key lookups and copies of the service setters.
+ * @remarks The @a service must be released with service_destroy() by you.
+ * The builder is not changed, so it can build more service handles.
+ * @param [in] builder The service builder handle
+ * @param [out] service The service handle to be newly created on success
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SERVICE_ERROR_OUT_OF_MEMORY Out of memory
+ * @see service_builder_create()
+ * @see service_destroy()
+ */
+int service_builder_build(service_builder_h builder, service_h *service);
+
+
+/**
+ * @brief Enumerations of the stages of the launch request recorded by the service trace.
+ */
+typedef enum
+{
+	SERVICE_TRACE_STAGE_SEND = 0, /**< The caller sends the launch request */
+	SERVICE_TRACE_STAGE_LAUNCHED, /**< The launch system has processed the launch request in the caller */
+	SERVICE_TRACE_STAGE_RECEIVE, /**< The callee receives the launch request */
+	SERVICE_TRACE_STAGE_SERVICE_CB_ENTER, /**< The callee invokes app_service_cb() */
+	SERVICE_TRACE_STAGE_SERVICE_CB_EXIT, /**< app_service_cb() returns in the callee */
+	SERVICE_TRACE_STAGE_REPLY, /**< The caller receives the reply */
+} service_trace_stage_e;
+
+
+/**
+ * @brief The structure type of a record of the service trace.
+ *
+ * @details A launch request is identified by the process ID of the caller and the ID of the request in the caller.
+ */
+typedef struct
+{
+	int pid; /**< The process ID of the caller */
+	int request_id; /**< The ID of the launch request in the caller */
+	service_trace_stage_e stage; /**< The stage of the launch request */
+	struct timespec timestamp; /**< The time when the stage is reached, read from CLOCK_MONOTONIC */
+} service_trace_record_s;
+
+
+/**
+ * @brief Called when a stage of the launch request is recorded.
+ *
+ * @remarks This callback can be called from the thread where the stage is reached.
+ * @param [in] record The record of the stage
+ * @param [in] user_data The user data passed from the callback registration function
+ * @see service_trace_set_cb()
+ */
+typedef void (*service_trace_cb)(const service_trace_record_s *record, void *user_data);
+
+
+/**
+ * @brief Called to retrieve the records kept in the service trace.
+ *
+ * @param [in] record The record of the stage
+ * @param [in] user_data The user data passed from the foreach function
+ * @return @c true to continue with the next iteration of the loop, \n @c false to break out of the loop.
+ * @see service_trace_foreach_record()
+ */
+typedef bool (*service_trace_record_cb)(const service_trace_record_s *record, void *user_data);
+
+
+/**
+ * @brief Enables or disables the service trace.
+ *
+ * @details While the service trace is enabled, the launch requests sent by the application carry a trace ID,
+ * and the stages of the traced launch requests are recorded with monotonic timestamps into a ring buffer.
+ * The callee records the stages only if it enables the service trace too.
+ * @remarks The service trace is disabled by default. It is enabled at startup if the environment variable CAPI_APPFW_SERVICE_TRACE is set to 1.
+ * @param [in] enable Whether the service trace is enabled
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @see service_trace_set_cb()
+ * @see service_trace_foreach_record()
+ */
+int service_trace_set_enabled(bool enable);
+
+
+/**
+ * @brief Registers a callback function to be invoked whenever a stage is recorded.
+ *
+ * @param [in] callback The callback function, or NULL to unregister it
+ * @param [in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @see service_trace_cb()
+ */
+int service_trace_set_cb(service_trace_cb callback, void *user_data);
+
+
+/**
+ * @brief Retrieves the records kept in the ring buffer of the service trace, from the oldest one.
+ *
+ * @param [in] callback The iteration callback function
+ * @param [in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ * @retval #SERVICE_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see service_trace_record_cb()
+ */
+int service_trace_foreach_record(service_trace_record_cb callback, void *user_data);
+
+
+/**
+ * @brief Writes the records kept in the ring buffer of the service trace to the system log.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ */
+int service_trace_dump(void);
+
+
+/**
+ * @brief Removes all records from the ring buffer of the service trace.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SERVICE_ERROR_NONE Successful
+ */
+int service_trace_clear(void);
+
+
 /**
  * @}
  */
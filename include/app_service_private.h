@@ -26,10 +26,41 @@ extern "C" {
 
 int service_create_request(bundle *data, service_h *service);
 
+/* the handle takes over the bundle, which is freed even if the handle cannot be created */
+int service_adopt_request(bundle *data, service_h *service);
+
 int service_create_event(bundle *data, service_h *service);
 
+/* the bundle is not duplicated until the handle changes it, so it must outlive the service handle */
+int service_create_event_borrowed(bundle *data, service_h *service);
+
 int service_to_bundle(service_h service, bundle **data);
 
+/* true if both handles carry the same operation, URI, MIME type, caller and extra data */
+bool service_payload_equals(service_h lhs, service_h rhs);
+
+typedef void (*service_local_dispatch_cb)(service_h service, void *user_data);
+
+/* the launch requests sent to the given application without a reply callback are passed to the callback on the main loop */
+int service_set_local_dispatcher(const char *app_id, service_local_dispatch_cb callback, void *user_data);
+
+int service_error(service_error_e error, const char* function, const char *description);
+
+int service_validate_internal_key(const char *key);
+
+/* drops the lookup caches and the free handles, returns the number of bytes released */
+size_t service_release_memory(void);
+
+bool service_trace_is_enabled(void);
+
+void service_trace_attach(bundle *data, int request_id);
+
+void service_trace_detach(bundle *data);
+
+void service_trace_record(bundle *data, service_trace_stage_e stage);
+
+void service_trace_record_request(int pid, int request_id, service_trace_stage_e stage);
+
 #ifdef __cplusplus
 }
 #endif
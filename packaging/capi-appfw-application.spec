@@ -16,6 +16,7 @@ BuildRequires:  pkgconfig(ail)
 BuildRequires:  pkgconfig(appsvc)
 BuildRequires:  pkgconfig(notification)
 BuildRequires:  pkgconfig(elementary)
+BuildRequires:  pkgconfig(ecore)
 BuildRequires:  pkgconfig(alarm-service)
 BuildRequires:  pkgconfig(capi-base-common)
 BuildRequires:  pkgconfig(sqlite3)
@@ -17,10 +17,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include <libintl.h>
 
+#include <dlog.h>
+
 #include <app_private.h>
 
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_APPLICATION"
+
 typedef struct _app_finalizer_s_ {
 	app_finalizer_cb callback;
 	void *data;
@@ -29,17 +39,45 @@ typedef struct _app_finalizer_s_ {
 
 typedef app_finalizer_s *app_finalizer_h;
 
-static app_finalizer_s finalizer_head = {
-	.callback = NULL,
-	.data = NULL,
-	.next = NULL
-};
+// one list per priority, the tail makes an addition constant time while keeping the registration order
+typedef struct {
+	app_finalizer_h head;
+	app_finalizer_h tail;
+} app_finalizer_bucket_s;
+
+static app_finalizer_bucket_s finalizer_buckets[APP_FINALIZER_PRIORITY_MAX];
+
+static pthread_mutex_t finalizer_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int finalizer_time_budget = 0;
+
+int app_set_shutdown_time_budget(int budget)
+{
+	if (budget < 0)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	finalizer_time_budget = budget;
+
+	return APP_ERROR_NONE;
+}
 
 int app_finalizer_add(app_finalizer_cb callback, void *data)
 {
-	app_finalizer_h finalizer_tail = &finalizer_head;
+	return app_finalizer_add_with_priority(callback, data, APP_FINALIZER_PRIORITY_DEFAULT);
+}
+
+int app_finalizer_add_with_priority(app_finalizer_cb callback, void *data, app_finalizer_priority_e priority)
+{
+	app_finalizer_bucket_s *bucket;
 	app_finalizer_h finalizer_new;
 
+	if (callback == NULL || priority < 0 || priority >= APP_FINALIZER_PRIORITY_MAX)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
 	finalizer_new = malloc(sizeof(app_finalizer_s));
 
 	if (finalizer_new == NULL)
@@ -51,55 +89,146 @@ int app_finalizer_add(app_finalizer_cb callback, void *data)
 	finalizer_new->data = data;
 	finalizer_new->next = NULL;
 
-	while (finalizer_tail->next)
+	pthread_mutex_lock(&finalizer_lock);
+
+	bucket = &finalizer_buckets[priority];
+
+	if (bucket->tail != NULL)
+	{
+		bucket->tail->next = finalizer_new;
+	}
+	else
 	{
-		finalizer_tail = finalizer_tail->next;
+		bucket->head = finalizer_new;
 	}
-	
-	finalizer_tail->next = finalizer_new;
+
+	bucket->tail = finalizer_new;
+
+	pthread_mutex_unlock(&finalizer_lock);
 
 	return APP_ERROR_NONE;
 }
 
 int app_finalizer_remove(app_finalizer_cb callback)
 {
-	app_finalizer_h finalizer_node = &finalizer_head;
+	app_finalizer_bucket_s *bucket;
+	app_finalizer_h previous_node;
+	app_finalizer_h finalizer_node;
+	int priority;
 
-	while (finalizer_node->next)
+	pthread_mutex_lock(&finalizer_lock);
+
+	for (priority = 0; priority < APP_FINALIZER_PRIORITY_MAX; priority++)
 	{
-		if (finalizer_node->next->callback == callback)
+		bucket = &finalizer_buckets[priority];
+		previous_node = NULL;
+
+		for (finalizer_node = bucket->head; finalizer_node != NULL; finalizer_node = finalizer_node->next)
 		{
-			app_finalizer_h removed_node = finalizer_node->next;
-			finalizer_node->next = removed_node->next;
-			free(removed_node);
+			if (finalizer_node->callback != callback)
+			{
+				previous_node = finalizer_node;
+				continue;
+			}
+
+			if (previous_node != NULL)
+			{
+				previous_node->next = finalizer_node->next;
+			}
+			else
+			{
+				bucket->head = finalizer_node->next;
+			}
+
+			if (bucket->tail == finalizer_node)
+			{
+				bucket->tail = previous_node;
+			}
+
+			pthread_mutex_unlock(&finalizer_lock);
+
+			free(finalizer_node);
+
 			return APP_ERROR_NONE;
 		}
+	}
 
-		finalizer_node = finalizer_node->next;
-	}	
+	pthread_mutex_unlock(&finalizer_lock);
 
 	return APP_ERROR_INVALID_PARAMETER;
 }
 
+static long long app_finalizer_elapsed_us(const struct timespec *from, const struct timespec *to)
+{
+	return (to->tv_sec - from->tv_sec) * 1000000LL + (to->tv_nsec - from->tv_nsec) / 1000;
+}
+
 void app_finalizer_execute(void)
 {
-	app_finalizer_h finalizer_node = &finalizer_head;
+	app_finalizer_bucket_s buckets[APP_FINALIZER_PRIORITY_MAX];
+	app_finalizer_h finalizer_node;
 	app_finalizer_h finalizer_executed;
-	app_finalizer_cb finalizer_cb = NULL;
-
-	while (finalizer_node->next)
+	struct timespec started;
+	struct timespec begin;
+	struct timespec end;
+	long long budget_us = finalizer_time_budget * 1000LL;
+	bool pending = true;
+	int skipped = 0;
+	int priority;
+
+	clock_gettime(CLOCK_MONOTONIC, &started);
+	end = started;
+
+	// the finalizers added by the running finalizers are run in the next round
+	while (pending == true)
 	{
-		finalizer_cb = finalizer_node->next->callback;
+		// the lists are detached first, so that the finalizers may add or remove finalizers safely
+		pthread_mutex_lock(&finalizer_lock);
 
-		finalizer_cb(finalizer_node->next->data);
+		memcpy(buckets, finalizer_buckets, sizeof(buckets));
+		memset(finalizer_buckets, 0, sizeof(finalizer_buckets));
 
-		finalizer_executed = finalizer_node->next;
+		pthread_mutex_unlock(&finalizer_lock);
 
-		finalizer_node = finalizer_node->next;
+		pending = false;
 
-		free(finalizer_executed);
+		for (priority = 0; priority < APP_FINALIZER_PRIORITY_MAX; priority++)
+		{
+			finalizer_node = buckets[priority].head;
+
+			while (finalizer_node != NULL)
+			{
+				pending = true;
+
+				// the critical finalizers run first and are never skipped
+				if (priority != APP_FINALIZER_PRIORITY_CRITICAL && budget_us > 0
+					&& app_finalizer_elapsed_us(&started, &end) >= budget_us)
+				{
+					skipped++;
+				}
+				else
+				{
+					clock_gettime(CLOCK_MONOTONIC, &begin);
+
+					finalizer_node->callback(finalizer_node->data);
+
+					clock_gettime(CLOCK_MONOTONIC, &end);
+
+					LOGD("[%s] finalizer %p (priority %d) took %lldus", __FUNCTION__,
+						finalizer_node->callback, priority, app_finalizer_elapsed_us(&begin, &end));
+				}
+
+				finalizer_executed = finalizer_node;
+				finalizer_node = finalizer_node->next;
+
+				free(finalizer_executed);
+			}
+		}
 	}
 
-	finalizer_head.next = NULL;
+	if (skipped > 0)
+	{
+		LOGW("[%s] %d finalizers skipped, the shutdown took %lldus of the %dms budget", __FUNCTION__,
+			skipped, app_finalizer_elapsed_us(&started, &end), finalizer_time_budget);
+	}
 }
-
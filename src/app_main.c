@@ -22,6 +22,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <time.h>
 
 #include <bundle.h>
 #include <appcore-common.h>
@@ -30,6 +31,7 @@
 #include <dlog.h>
 
 #include <Elementary.h>
+#include <Ecore.h>
 
 #include <app_private.h>
 #include <app_service_private.h>
@@ -56,6 +58,45 @@ typedef struct {
 
 typedef app_context_s *app_context_h;
 
+typedef struct {
+	service_h service;
+	struct timespec dispatched;
+} app_service_coalescing_s;
+
+// the order of the events is the order in which the queued events are dispatched, the low memory event is dispatched right away
+typedef enum {
+	APP_LIFECYCLE_EVENT_LOW_MEMORY,
+	APP_LIFECYCLE_EVENT_LOW_BATTERY,
+	APP_LIFECYCLE_EVENT_LANG_CHANGE,
+	APP_LIFECYCLE_EVENT_REGION_CHANGE,
+	APP_LIFECYCLE_EVENT_ROTATION,
+	APP_LIFECYCLE_EVENT_MAX,
+} app_lifecycle_event_e;
+
+typedef struct {
+	unsigned int pending;
+	enum appcore_rm rotation;
+	Ecore_Job *job;
+} app_lifecycle_queue_s;
+
+static app_lifecycle_queue_s app_lifecycle_queue = {0, APPCORE_RM_UNKNOWN, NULL};
+
+typedef struct _app_held_service_s_ {
+	service_h service;
+	struct _app_held_service_s_ *next;
+} app_held_service_s;
+
+// the launch requests the application sends to itself before it is running, in the order they were sent
+static app_held_service_s *app_held_services_head = NULL;
+static app_held_service_s *app_held_services_tail = NULL;
+static Ecore_Job *app_held_services_job = NULL;
+
+static bool app_i18n_deferred = false;
+static Ecore_Idler *app_i18n_idler = NULL;
+
+static int app_service_coalescing_window = 0;
+static app_service_coalescing_s app_last_service = {NULL, {0, 0}};
+
 static int app_appcore_create(void *data);
 static int app_appcore_pause(void *data);
 static int app_appcore_resume(void *data);
@@ -68,6 +109,16 @@ static int app_appcore_rotation_event(enum appcore_rm rm, void *data);
 static int app_appcore_lang_changed(void *data);
 static int app_appcore_region_changed(void *data);
 
+static bool app_service_coalesce(service_h service);
+static void app_service_coalescing_reset(void);
+static void app_dispatch_service(app_context_h app_context, service_h service);
+static void app_service_local_dispatch(service_h service, void *data);
+static void app_service_dispatch_held(void *data);
+static void app_service_release_held(void);
+
+static void app_lifecycle_event_queue(app_context_h app_context, app_lifecycle_event_e event);
+static void app_lifecycle_event_dispatch(app_context_h app_context, app_lifecycle_event_e event, enum appcore_rm rotation);
+
 static void app_set_appcore_event_cb(app_context_h app_context);
 static void app_unset_appcore_event_cb(void);
 
@@ -106,20 +157,38 @@ int app_efl_main(int *argc, char ***argv, app_event_callback_s *callback, void *
 		return app_error(APP_ERROR_ALREADY_RUNNING, __FUNCTION__, NULL);
 	}
 
+	app_startup_phase_begin(APP_STARTUP_PHASE_GET_PACKAGE);
+
 	if (app_get_package(&(app_context.package)) != APP_ERROR_NONE)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package");
 	}
+
+	app_startup_phase_end(APP_STARTUP_PHASE_GET_PACKAGE);
+	app_startup_phase_begin(APP_STARTUP_PHASE_GET_APP_NAME);
 	
 	if (app_get_package_app_name(app_context.package, &(app_context.app_name)) != APP_ERROR_NONE)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package's app name");
 	}
 
+	app_startup_phase_end(APP_STARTUP_PHASE_GET_APP_NAME);
+
+	app_prefetch_start();
+
 	app_context.state = APP_STATE_CREATING;
 
+	// ends when appcore calls back app_appcore_create()
+	app_startup_phase_begin(APP_STARTUP_PHASE_APPCORE_INIT);
+
 	appcore_efl_main(app_context.app_name, argc, argv, &appcore_context);
 
+	// the dispatcher and the pending i18n setup refer to the app context on this stack
+	service_set_local_dispatcher(NULL, NULL, NULL);
+	app_service_release_held();
+	app_service_coalescing_reset();
+	app_i18n_defer_init(NULL, NULL);
+
 	free(app_context.package);
 	free(app_context.app_name);
 
@@ -133,11 +202,49 @@ void app_efl_exit(void)
 }
 
 
+void app_set_deferred_i18n(bool enable)
+{
+	app_i18n_deferred = enable;
+}
+
+static void app_setup_i18n(void *data)
+{
+	app_context_h app_context = data;
+	const char *locale_dir;
+
+	app_startup_phase_begin(APP_STARTUP_PHASE_LOCALE_PROBE);
+	locale_dir = app_get_path(APP_PATH_LOCALE);
+	app_startup_phase_end(APP_STARTUP_PHASE_LOCALE_PROBE);
+
+	if (locale_dir == NULL)
+	{
+		app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the path to the locale directory");
+		return;
+	}
+
+	app_startup_phase_begin(APP_STARTUP_PHASE_I18N);
+	appcore_set_i18n(app_context->app_name, locale_dir);
+	app_startup_phase_end(APP_STARTUP_PHASE_I18N);
+}
+
+static Eina_Bool app_setup_i18n_on_idle(void *data)
+{
+	(void)data;
+
+	app_i18n_idler = NULL;
+
+	app_i18n_run_pending_init();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
 int app_appcore_create(void *data)
 {
 	app_context_h app_context = data;
 	app_create_cb create_cb;
-	char locale_dir[TIZEN_PATH_MAX] = {0, };
+	bool created;
+
+	app_startup_phase_end(APP_STARTUP_PHASE_APPCORE_INIT);
 
 	if (app_context == NULL)
 	{
@@ -146,21 +253,47 @@ int app_appcore_create(void *data)
 
 	app_set_appcore_event_cb(app_context);
 
-	snprintf(locale_dir, TIZEN_PATH_MAX, PATH_FMT_LOCALE_DIR, app_context->package);
-	if (access(locale_dir, R_OK) != 0) {
-		snprintf(locale_dir, TIZEN_PATH_MAX, PATH_FMT_RO_LOCALE_DIR, app_context->package);
+	service_set_local_dispatcher(app_context->package, app_service_local_dispatch, app_context);
+
+	app_prefetch_schedule_stop();
+
+	if (app_i18n_deferred == true)
+	{
+		// set up on the first i18n_get_text() or when the first frame is done, whichever comes first
+		app_i18n_defer_init(app_setup_i18n, app_context);
+		app_i18n_idler = ecore_idler_add(app_setup_i18n_on_idle, NULL);
+	}
+	else
+	{
+		app_setup_i18n(app_context);
 	}
-	appcore_set_i18n(app_context->app_name, locale_dir);
 
 	create_cb = app_context->callback->create;
 
-	if (create_cb == NULL || create_cb(app_context->data) == false)
+	app_startup_phase_begin(APP_STARTUP_PHASE_CREATE_CB);
+	created = create_cb != NULL && create_cb(app_context->data) == true;
+	app_startup_phase_end(APP_STARTUP_PHASE_CREATE_CB);
+
+	app_startup_dump();
+
+	if (created == false)
 	{
+		app_service_release_held();
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "app_create_cb() returns false");
 	}
 
 	app_context->state = APP_STATE_RUNNING;
 
+	if (app_held_services_head != NULL)
+	{
+		app_held_services_job = ecore_job_add(app_service_dispatch_held, app_context);
+
+		if (app_held_services_job == NULL)
+		{
+			app_service_dispatch_held(app_context);
+		}
+	}
+
 	return APP_ERROR_NONE;
 }
 
@@ -183,6 +316,14 @@ int app_appcore_terminate(void *data)
 
 	app_unset_appcore_event_cb();	
 
+	app_prefetch_stop();
+
+	if (app_i18n_idler != NULL)
+	{
+		ecore_idler_del(app_i18n_idler);
+		app_i18n_idler = NULL;
+	}
+
 	app_finalizer_execute();
 
 	return APP_ERROR_NONE;
@@ -205,6 +346,11 @@ int app_appcore_pause(void *data)
 		pause_cb(app_context->data);
 	}
 
+	if (app_reclaimer_is_enabled_on_pause())
+	{
+		app_reclaimer_execute();
+	}
+
 	return APP_ERROR_NONE;
 }
 
@@ -229,10 +375,124 @@ int app_appcore_resume(void *data)
 }
 
 
+static void app_dispatch_service(app_context_h app_context, service_h service)
+{
+	app_service_cb service_cb;
+	bundle *data = NULL;
+
+	service_to_bundle(service, &data);
+
+	service_trace_record(data, SERVICE_TRACE_STAGE_RECEIVE);
+
+	if (app_service_coalesce(service) == true)
+	{
+		LOGI("[%s] the launch request is coalesced into the previous one", __FUNCTION__);
+		return;
+	}
+
+	service_cb = app_context->callback->service;
+
+	if (service_cb != NULL)
+	{
+		service_trace_record(data, SERVICE_TRACE_STAGE_SERVICE_CB_ENTER);
+		service_cb(service, app_context->data);
+		service_trace_record(data, SERVICE_TRACE_STAGE_SERVICE_CB_EXIT);
+	}
+}
+
+static void app_service_dispatch_held(void *data)
+{
+	app_context_h app_context = data;
+	app_held_service_s *held;
+
+	app_held_services_job = NULL;
+
+	while (app_held_services_head != NULL)
+	{
+		held = app_held_services_head;
+		app_held_services_head = held->next;
+
+		if (app_held_services_head == NULL)
+		{
+			app_held_services_tail = NULL;
+		}
+
+		app_dispatch_service(app_context, held->service);
+
+		service_destroy(held->service);
+		free(held);
+	}
+}
+
+void app_service_release_held(void)
+{
+	app_held_service_s *held;
+
+	if (app_held_services_job != NULL)
+	{
+		ecore_job_del(app_held_services_job);
+		app_held_services_job = NULL;
+	}
+
+	while (app_held_services_head != NULL)
+	{
+		held = app_held_services_head;
+		app_held_services_head = held->next;
+
+		LOGW("[%s] the launch request to the application itself is discarded", __FUNCTION__);
+
+		service_destroy(held->service);
+		free(held);
+	}
+
+	app_held_services_tail = NULL;
+}
+
+// the launch requests sent by the application to itself, delivered on the main loop by the service module
+static void app_service_local_dispatch(service_h service, void *data)
+{
+	app_context_h app_context = data;
+	app_held_service_s *held;
+
+	if (app_context == NULL)
+	{
+		return;
+	}
+
+	// the requests sent before app_create_cb() returns are held until the application is running
+	if (app_context->state != APP_STATE_RUNNING || app_held_services_head != NULL)
+	{
+		held = malloc(sizeof(app_held_service_s));
+
+		if (held == NULL || service_clone(&held->service, service) != SERVICE_ERROR_NONE)
+		{
+			free(held);
+			app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to hold the launch request");
+			return;
+		}
+
+		held->next = NULL;
+
+		if (app_held_services_tail != NULL)
+		{
+			app_held_services_tail->next = held;
+		}
+		else
+		{
+			app_held_services_head = held;
+		}
+
+		app_held_services_tail = held;
+
+		return;
+	}
+
+	app_dispatch_service(app_context, service);
+}
+
 int app_appcore_reset(bundle *appcore_bundle, void *data)
 {
 	app_context_h app_context = data;
-	app_service_cb service_cb;
 	service_h service;
 
 	if (app_context == NULL)
@@ -240,19 +500,93 @@ int app_appcore_reset(bundle *appcore_bundle, void *data)
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, NULL);
 	}
 
-	if (service_create_event(appcore_bundle, &service) != APP_ERROR_NONE)
+	// appcore keeps the bundle alive until this callback returns
+	if (service_create_event_borrowed(appcore_bundle, &service) != APP_ERROR_NONE)
 	{
 		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to create a service handle from the bundle");
 	}
 
-	service_cb = app_context->callback->service;
+	app_dispatch_service(app_context, service);
 
-	if (service_cb != NULL)
+	service_destroy(service);
+
+	return APP_ERROR_NONE;
+}
+
+
+static void app_service_coalescing_reset(void)
+{
+	if (app_last_service.service != NULL)
 	{
-		service_cb(service, app_context->data);
+		service_destroy(app_last_service.service);
 	}
 
-	service_destroy(service);
+	app_last_service.service = NULL;
+	app_last_service.dispatched.tv_sec = 0;
+	app_last_service.dispatched.tv_nsec = 0;
+}
+
+// returns true if the launch request is identical to the one dispatched within the coalescing window
+static bool app_service_coalesce(service_h service)
+{
+	struct timespec now;
+	long long elapsed;
+	bool reply_requested = false;
+	bool coalesced = false;
+	service_h last_service = NULL;
+
+	if (app_service_coalescing_window <= 0)
+	{
+		return false;
+	}
+
+	// the caller is waiting for the reply to each request, so none of them can be dropped
+	if (service_is_reply_requested(service, &reply_requested) != SERVICE_ERROR_NONE || reply_requested == true)
+	{
+		return false;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	if (app_last_service.service != NULL)
+	{
+		elapsed = (now.tv_sec - app_last_service.dispatched.tv_sec) * 1000LL
+			+ (now.tv_nsec - app_last_service.dispatched.tv_nsec) / 1000000;
+
+		coalesced = elapsed < app_service_coalescing_window
+			&& service_payload_equals(service, app_last_service.service);
+	}
+
+	if (coalesced == true)
+	{
+		return true;
+	}
+
+	// the window starts from the request which is actually dispatched
+	app_service_coalescing_reset();
+
+	if (service_clone(&last_service, service) == SERVICE_ERROR_NONE)
+	{
+		app_last_service.service = last_service;
+		app_last_service.dispatched = now;
+	}
+
+	return false;
+}
+
+int app_set_service_coalescing_window(int window)
+{
+	if (window < 0)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	app_service_coalescing_window = window;
+
+	if (window == 0)
+	{
+		app_service_coalescing_reset();
+	}
 
 	return APP_ERROR_NONE;
 }
@@ -261,19 +595,16 @@ int app_appcore_reset(bundle *appcore_bundle, void *data)
 int app_appcore_low_memory(void *data)
 {
 	app_context_h app_context = data;
-	app_low_memory_cb low_memory_cb;
 
 	if (app_context == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, NULL);
 	}
 
-	low_memory_cb = app_context->callback->low_memory;
+	app_reclaimer_execute();
 
-	if (low_memory_cb != NULL)
-	{
-		low_memory_cb(app_context->data);
-	}
+	// the application has to release its memory before the system picks a process to kill, so this event is never queued
+	app_lifecycle_event_dispatch(app_context, APP_LIFECYCLE_EVENT_LOW_MEMORY, APPCORE_RM_UNKNOWN);
 
 	return APP_ERROR_NONE;
 }
@@ -281,19 +612,13 @@ int app_appcore_low_memory(void *data)
 int app_appcore_low_battery(void *data)
 {
 	app_context_h app_context = data;
-	app_low_battery_cb low_battery_cb;
 
 	if (app_context == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, NULL);
 	}
 
-	low_battery_cb = app_context->callback->low_battery;
-
-	if (low_battery_cb != NULL)
-	{
-		low_battery_cb(app_context->data);
-	}
+	app_lifecycle_event_queue(app_context, APP_LIFECYCLE_EVENT_LOW_BATTERY);
 
 	return APP_ERROR_NONE;
 }
@@ -301,23 +626,16 @@ int app_appcore_low_battery(void *data)
 int app_appcore_rotation_event(enum appcore_rm rm, void *data)
 {
 	app_context_h app_context = data;
-	app_device_orientation_cb device_orientation_cb;
 
 	if (app_context == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, NULL);
 	}
 
-	device_orientation_cb = app_context->callback->device_orientation;
-
-	if (device_orientation_cb != NULL)
-	{
-		app_device_orientation_e dev_orientation;
-
-		dev_orientation = app_convert_appcore_rm(rm);
+	// only the last rotation of a burst is delivered
+	app_lifecycle_queue.rotation = rm;
 
-		device_orientation_cb(dev_orientation, app_context->data);
-	}
+	app_lifecycle_event_queue(app_context, APP_LIFECYCLE_EVENT_ROTATION);
 
 	return APP_ERROR_NONE;
 }
@@ -325,19 +643,13 @@ int app_appcore_rotation_event(enum appcore_rm rm, void *data)
 int app_appcore_lang_changed(void *data)
 {
 	app_context_h app_context = data;
-	app_language_changed_cb lang_changed_cb;
 
 	if (app_context == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, NULL);
 	}
 
-	lang_changed_cb = app_context->callback->language_changed;
-
-	if (lang_changed_cb != NULL)
-	{
-		lang_changed_cb(app_context->data);
-	}
+	app_lifecycle_event_queue(app_context, APP_LIFECYCLE_EVENT_LANG_CHANGE);
 
 	return APP_ERROR_NONE;
 }
@@ -345,30 +657,109 @@ int app_appcore_lang_changed(void *data)
 int app_appcore_region_changed(void *data)
 {
 	app_context_h app_context = data;
-	app_region_format_changed_cb region_changed_cb;
 
 	if (app_context == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, NULL);
 	}
 
-	region_changed_cb = app_context->callback->region_format_changed;
+	app_lifecycle_event_queue(app_context, APP_LIFECYCLE_EVENT_REGION_CHANGE);
+
+	return APP_ERROR_NONE;
+}
+
+static void app_lifecycle_event_job(void *data)
+{
+	app_context_h app_context = data;
+	unsigned int pending;
+	enum appcore_rm rotation;
+	int event;
+
+	// the events raised by the callbacks below are queued for the next job instead of cascading
+	pending = app_lifecycle_queue.pending;
+	rotation = app_lifecycle_queue.rotation;
+
+	app_lifecycle_queue.pending = 0;
+	app_lifecycle_queue.job = NULL;
+
+	for (event = 0; event < APP_LIFECYCLE_EVENT_MAX; event++)
+	{
+		if (pending & (1U << event))
+		{
+			app_lifecycle_event_dispatch(app_context, event, rotation);
+		}
+	}
+}
+
+// the duplicates of a pending event are merged, so a storm of events costs one callback per event type
+void app_lifecycle_event_queue(app_context_h app_context, app_lifecycle_event_e event)
+{
+	app_lifecycle_queue.pending |= (1U << event);
 
-	if (region_changed_cb != NULL)
+	if (app_lifecycle_queue.job != NULL)
 	{
-		region_changed_cb(app_context->data);
+		return;
 	}
 
-	return APP_ERROR_NONE;
-}
+	app_lifecycle_queue.job = ecore_job_add(app_lifecycle_event_job, app_context);
 
+	if (app_lifecycle_queue.job == NULL)
+	{
+		LOGW("[%s] failed to queue the event, dispatching it now", __FUNCTION__);
+		app_lifecycle_event_job(app_context);
+	}
+}
 
-void app_set_appcore_event_cb(app_context_h app_context)
+void app_lifecycle_event_dispatch(app_context_h app_context, app_lifecycle_event_e event, enum appcore_rm rotation)
 {
-	if (app_context->callback->low_memory != NULL)
+	app_event_callback_s *callback = app_context->callback;
+
+	switch (event)
 	{
-		appcore_set_event_callback(APPCORE_EVENT_LOW_MEMORY, app_appcore_low_memory, app_context);
+	case APP_LIFECYCLE_EVENT_LOW_MEMORY:
+		if (callback->low_memory != NULL)
+		{
+			callback->low_memory(app_context->data);
+		}
+		break;
+
+	case APP_LIFECYCLE_EVENT_LOW_BATTERY:
+		if (callback->low_battery != NULL)
+		{
+			callback->low_battery(app_context->data);
+		}
+		break;
+
+	case APP_LIFECYCLE_EVENT_LANG_CHANGE:
+		if (callback->language_changed != NULL)
+		{
+			callback->language_changed(app_context->data);
+		}
+		break;
+
+	case APP_LIFECYCLE_EVENT_REGION_CHANGE:
+		if (callback->region_format_changed != NULL)
+		{
+			callback->region_format_changed(app_context->data);
+		}
+		break;
+
+	case APP_LIFECYCLE_EVENT_ROTATION:
+		if (callback->device_orientation != NULL)
+		{
+			callback->device_orientation(app_convert_appcore_rm(rotation), app_context->data);
+		}
+		break;
+
+	default:
+		break;
 	}
+}
+
+void app_set_appcore_event_cb(app_context_h app_context)
+{
+	// the low memory event is always handled, the library releases its own caches on it
+	appcore_set_event_callback(APPCORE_EVENT_LOW_MEMORY, app_appcore_low_memory, app_context);
 
 	if (app_context->callback->low_battery != NULL)
 	{
@@ -398,4 +789,13 @@ void app_unset_appcore_event_cb(void)
 	appcore_unset_rotation_cb();
 	appcore_set_event_callback(APPCORE_EVENT_LANG_CHANGE, NULL, NULL);
 	appcore_set_event_callback(APPCORE_EVENT_REGION_CHANGE, NULL, NULL);
+
+	// the queued events are dropped, the application is going away
+	if (app_lifecycle_queue.job != NULL)
+	{
+		ecore_job_del(app_lifecycle_queue.job);
+		app_lifecycle_queue.job = NULL;
+	}
+
+	app_lifecycle_queue.pending = 0;
 }
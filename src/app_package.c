@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -72,21 +73,55 @@ int app_get_package(char **package)
 	return app_get_id(package);
 }
 
+// the ID does not change for the lifetime of the process
+static char app_id_buf[TIZEN_PATH_MAX] = {0, };
+static volatile bool app_id_valid = false;
+static pthread_mutex_t app_id_lock = PTHREAD_MUTEX_INITIALIZER;
+
+const char* app_peek_id(void)
+{
+	char id_buf[TIZEN_PATH_MAX] = {0, };
+
+	// a failure is retried on the next call, the buffer is never written once a reader may see it
+	if (app_id_valid == false)
+	{
+		pthread_mutex_lock(&app_id_lock);
+
+		if (app_id_valid == false
+			&& aul_app_get_pkgname_bypid(getpid(), id_buf, sizeof(id_buf)) == AUL_R_OK
+			&& id_buf[0] != '\0')
+		{
+			memcpy(app_id_buf, id_buf, sizeof(app_id_buf));
+
+			__sync_synchronize();
+			app_id_valid = true;
+		}
+
+		pthread_mutex_unlock(&app_id_lock);
+
+		if (app_id_valid == false)
+		{
+			return NULL;
+		}
+	}
+
+	__sync_synchronize();
+
+	return app_id_buf;
+}
+
 int app_get_id(char **id)
 {
-	static char id_buf[TIZEN_PATH_MAX] = {0, };
+	const char *id_buf;
 
 	if (id == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	if (id_buf[0] == '\0')
-	{
-		aul_app_get_pkgname_bypid(getpid(), id_buf, sizeof(id_buf));
-	}
+	id_buf = app_peek_id();
 
-	if (id_buf[0] == '\0')
+	if (id_buf == NULL)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the application ID");
 	}
@@ -101,84 +136,200 @@ int app_get_id(char **id)
 	return APP_ERROR_NONE;
 }
 
-static int app_get_appinfo(const char *package, const char *property, char **value)
+// the strings returned by the peek functions are never released, so there is one generation per language
+typedef struct _app_appinfo_cache_s_ {
+	char *language;
+	char *name;
+	char *version;
+	struct _app_appinfo_cache_s_ *next;
+} app_appinfo_cache_s;
+
+typedef enum {
+	APP_APPINFO_NAME,
+	APP_APPINFO_VERSION,
+} app_appinfo_field_e;
+
+static app_appinfo_cache_s *app_appinfo_cache = NULL;
+static app_appinfo_cache_s *app_appinfo_generations = NULL;
+static pthread_mutex_t app_appinfo_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool app_appinfo_cache_matches(app_appinfo_cache_s *cache, const char *language)
+{
+	// the name is localized, so the cache follows the language of the device
+	if (language == NULL || cache->language == NULL)
+	{
+		return language == cache->language;
+	}
+
+	return !strcmp(language, cache->language);
+}
+
+static char* app_appinfo_dup_str(ail_appinfo_h appinfo, const char *property)
 {
+	char *value = NULL;
+
+	if (ail_appinfo_get_str(appinfo, property, &value) != 0 || value == NULL)
+	{
+		return NULL;
+	}
+
+	return strdup(value);
+}
+
+// all the properties are fetched with a single query and kept for the lifetime of the process,
+// must be called with app_appinfo_lock held
+static int app_appinfo_cache_load(void)
+{
+	const char *language = getenv("LANG");
+	const char *package;
 	ail_appinfo_h appinfo;
-	char *appinfo_value;
-	char *appinfo_value_dup;
+	app_appinfo_cache_s *cache;
+
+	if (app_appinfo_cache != NULL && app_appinfo_cache_matches(app_appinfo_cache, language))
+	{
+		return APP_ERROR_NONE;
+	}
+
+	// switching back to a language seen before costs no query
+	for (cache = app_appinfo_generations; cache != NULL; cache = cache->next)
+	{
+		if (app_appinfo_cache_matches(cache, language))
+		{
+			app_appinfo_cache = cache;
+			return APP_ERROR_NONE;
+		}
+	}
+
+	package = app_peek_id();
+
+	if (package == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package");
+	}
 
 	if (ail_package_get_appinfo(package, &appinfo) != 0)
 	{
 		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get app-info");
 	}
-	
-	if (ail_appinfo_get_str(appinfo, property, &appinfo_value) != 0)
+
+	cache = calloc(1, sizeof(app_appinfo_cache_s));
+
+	if (cache == NULL)
 	{
 		ail_package_destroy_appinfo(appinfo);
-		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get app-property");
+		return app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
 	}
 
-	appinfo_value_dup = strdup(appinfo_value);
+	cache->name = app_appinfo_dup_str(appinfo, AIL_PROP_NAME_STR);
+	cache->version = app_appinfo_dup_str(appinfo, AIL_PROP_VERSION_STR);
 
 	ail_package_destroy_appinfo(appinfo);
 
-	if (appinfo_value_dup == NULL)
+	if (language != NULL)
 	{
-		return app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+		cache->language = strdup(language);
+
+		if (cache->language == NULL)
+		{
+			free(cache->name);
+			free(cache->version);
+			free(cache);
+			return app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+		}
 	}
 
-	*value = appinfo_value_dup;
-	
+	cache->next = app_appinfo_generations;
+	app_appinfo_generations = cache;
+	app_appinfo_cache = cache;
+
 	return APP_ERROR_NONE;
 }
 
-int app_get_name(char **name)
+static const char* app_appinfo_cache_get(app_appinfo_field_e field)
 {
-	char *package = NULL;
-	int retval;
+	return field == APP_APPINFO_NAME ? app_appinfo_cache->name : app_appinfo_cache->version;
+}
 
-	if(name == NULL)
-	{
-		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-	}
+static const char* app_peek_appinfo(const char *function, app_appinfo_field_e field)
+{
+	const char *value = NULL;
+
+	pthread_mutex_lock(&app_appinfo_lock);
 
-	if (app_get_package(&package) != 0)
+	if (app_appinfo_cache_load() == APP_ERROR_NONE)
 	{
-		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package");
+		value = app_appinfo_cache_get(field);
+
+		if (value == NULL)
+		{
+			app_error(APP_ERROR_INVALID_CONTEXT, function, "failed to get app-property");
+		}
 	}
 
-	retval = app_get_appinfo(package, AIL_PROP_NAME_STR, name);
+	pthread_mutex_unlock(&app_appinfo_lock);
 
-	if (package != NULL)
-	{
-		free(package);
-	}
+	return value;
+}
 
-	return retval;
+const char* app_peek_name(void)
+{
+	return app_peek_appinfo(__FUNCTION__, APP_APPINFO_NAME);
 }
 
-int app_get_version(char **version)
+const char* app_peek_version(void)
 {
-	char *package;
+	return app_peek_appinfo(__FUNCTION__, APP_APPINFO_VERSION);
+}
+
+static int app_get_appinfo(const char *function, app_appinfo_field_e field, char **value)
+{
+	const char *cached_value;
 	int retval;
 
-	if(version == NULL)
+	pthread_mutex_lock(&app_appinfo_lock);
+
+	retval = app_appinfo_cache_load();
+
+	if (retval == APP_ERROR_NONE)
 	{
-		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		cached_value = app_appinfo_cache_get(field);
+
+		if (cached_value == NULL)
+		{
+			retval = app_error(APP_ERROR_INVALID_CONTEXT, function, "failed to get app-property");
+		}
+		else
+		{
+			*value = strdup(cached_value);
+
+			if (*value == NULL)
+			{
+				retval = app_error(APP_ERROR_OUT_OF_MEMORY, function, NULL);
+			}
+		}
 	}
 
-	if (app_get_package(&package) != 0)
+	pthread_mutex_unlock(&app_appinfo_lock);
+
+	return retval;
+}
+
+int app_get_name(char **name)
+{
+	if(name == NULL)
 	{
-		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package");
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	retval = app_get_appinfo(package, AIL_PROP_VERSION_STR, version);
+	return app_get_appinfo(__FUNCTION__, APP_APPINFO_NAME, name);
+}
 
-	if (package != NULL)
+int app_get_version(char **version)
+{
+	if(version == NULL)
 	{
-		free(package);
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	return retval;	
+	return app_get_appinfo(__FUNCTION__, APP_APPINFO_VERSION, version);
 }
-
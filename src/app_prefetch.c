@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include <dlog.h>
+#include <Ecore.h>
+
+#include <app_private.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_APPLICATION"
+
+#define PREFETCH_LIST_NAME ".resource_prefetch"
+#define PREFETCH_MAX_RESOURCES 1024
+
+static int prefetch_duration = 0;
+static volatile bool prefetch_recording = false;
+static char *prefetch_resources[PREFETCH_MAX_RESOURCES];
+static int prefetch_resource_count = 0;
+static struct timespec prefetch_started;
+static Ecore_Timer *prefetch_timer = NULL;
+static pthread_mutex_t prefetch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int app_set_resource_prefetch(int duration)
+{
+	if (duration < 0)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	prefetch_duration = duration;
+
+	return APP_ERROR_NONE;
+}
+
+static void app_prefetch_get_list_path(char *buffer, int size)
+{
+	const char *data_directory = app_get_path(APP_PATH_DATA);
+
+	if (data_directory == NULL)
+	{
+		buffer[0] = '\0';
+		return;
+	}
+
+	snprintf(buffer, size, "%s/%s", data_directory, PREFETCH_LIST_NAME);
+}
+
+// the page cache is warmed up in the background, so the main thread finds the resources in memory
+static void* app_prefetch_thread(void *data)
+{
+	FILE *list = data;
+	const char *resource_directory = app_get_path(APP_PATH_RES);
+	char resource[TIZEN_PATH_MAX];
+	char path[TIZEN_PATH_MAX];
+	size_t length;
+	int fd;
+
+	while (resource_directory != NULL && fgets(resource, sizeof(resource), list) != NULL)
+	{
+		length = strlen(resource);
+
+		if (length > 0 && resource[length - 1] == '\n')
+		{
+			resource[length - 1] = '\0';
+		}
+
+		if (resource[0] == '\0')
+		{
+			continue;
+		}
+
+		snprintf(path, sizeof(path), "%s/%s", resource_directory, resource);
+
+		fd = open(path, O_RDONLY | O_CLOEXEC);
+
+		if (fd < 0)
+		{
+			continue;
+		}
+
+		posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+		close(fd);
+	}
+
+	fclose(list);
+
+	return NULL;
+}
+
+void app_prefetch_start(void)
+{
+	char list_path[TIZEN_PATH_MAX] = {0, };
+	pthread_attr_t attr;
+	pthread_t thread;
+	FILE *list;
+
+	if (prefetch_duration <= 0)
+	{
+		return;
+	}
+
+	app_prefetch_get_list_path(list_path, sizeof(list_path));
+
+	if (list_path[0] == '\0')
+	{
+		return;
+	}
+
+	list = fopen(list_path, "r");
+
+	if (list != NULL)
+	{
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+		if (pthread_create(&thread, &attr, app_prefetch_thread, list) != 0)
+		{
+			LOGW("[%s] failed to start prefetching the resources", __FUNCTION__);
+			fclose(list);
+		}
+
+		pthread_attr_destroy(&attr);
+	}
+
+	// the list is recorded again on every launch, so it follows what the application actually uses
+	clock_gettime(CLOCK_MONOTONIC, &prefetch_started);
+	prefetch_recording = true;
+}
+
+void app_prefetch_record(const char *resource)
+{
+	int i;
+
+	if (prefetch_recording == false)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&prefetch_lock);
+
+	if (prefetch_recording == true && prefetch_resource_count < PREFETCH_MAX_RESOURCES)
+	{
+		for (i = 0; i < prefetch_resource_count; i++)
+		{
+			if (!strcmp(prefetch_resources[i], resource))
+			{
+				break;
+			}
+		}
+
+		if (i == prefetch_resource_count && strchr(resource, '\n') == NULL)
+		{
+			prefetch_resources[i] = strdup(resource);
+
+			if (prefetch_resources[i] != NULL)
+			{
+				prefetch_resource_count++;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&prefetch_lock);
+}
+
+void app_prefetch_stop(void)
+{
+	char list_path[TIZEN_PATH_MAX] = {0, };
+	char temp_path[TIZEN_PATH_MAX] = {0, };
+	FILE *list = NULL;
+	int i;
+
+	if (prefetch_timer != NULL)
+	{
+		ecore_timer_del(prefetch_timer);
+		prefetch_timer = NULL;
+	}
+
+	pthread_mutex_lock(&prefetch_lock);
+
+	if (prefetch_recording == false)
+	{
+		pthread_mutex_unlock(&prefetch_lock);
+		return;
+	}
+
+	prefetch_recording = false;
+
+	app_prefetch_get_list_path(list_path, sizeof(list_path));
+
+	if (list_path[0] != '\0')
+	{
+		snprintf(temp_path, sizeof(temp_path), "%s.%d", list_path, getpid());
+		list = fopen(temp_path, "w");
+	}
+
+	for (i = 0; i < prefetch_resource_count; i++)
+	{
+		if (list != NULL)
+		{
+			fprintf(list, "%s\n", prefetch_resources[i]);
+		}
+
+		free(prefetch_resources[i]);
+		prefetch_resources[i] = NULL;
+	}
+
+	prefetch_resource_count = 0;
+
+	pthread_mutex_unlock(&prefetch_lock);
+
+	if (list != NULL)
+	{
+		if (fclose(list) != 0 || rename(temp_path, list_path) != 0)
+		{
+			LOGW("[%s] failed to save the prefetch list", __FUNCTION__);
+			unlink(temp_path);
+		}
+	}
+}
+
+static Eina_Bool app_prefetch_timeout_cb(void *data)
+{
+	(void)data;
+
+	prefetch_timer = NULL;
+
+	app_prefetch_stop();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+// the main loop is not running yet when the recording starts
+void app_prefetch_schedule_stop(void)
+{
+	struct timespec now;
+	double remaining;
+
+	if (prefetch_recording == false || prefetch_timer != NULL)
+	{
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	remaining = prefetch_duration - (now.tv_sec - prefetch_started.tv_sec)
+		- (now.tv_nsec - prefetch_started.tv_nsec) / 1000000000.0;
+
+	if (remaining <= 0)
+	{
+		app_prefetch_stop();
+		return;
+	}
+
+	prefetch_timer = ecore_timer_add(remaining, app_prefetch_timeout_cb, NULL);
+}
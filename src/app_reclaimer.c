@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <dlog.h>
+
+#include <app_private.h>
+#include <app_service.h>
+#include <app_service_private.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_APPLICATION"
+
+typedef struct _app_reclaimer_s_ {
+	app_reclaimer_cb callback;
+	void *data;
+	struct _app_reclaimer_s_ *next;
+} app_reclaimer_s;
+
+typedef app_reclaimer_s *app_reclaimer_h;
+
+static app_reclaimer_s reclaimer_head = {
+	.callback = NULL,
+	.data = NULL,
+	.next = NULL
+};
+
+static pthread_mutex_t reclaimer_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool reclaimer_on_pause = false;
+
+static size_t app_reclaimer_release_service(void *data)
+{
+	(void)data;
+
+	return service_release_memory();
+}
+
+static size_t app_reclaimer_release_resource_index(void *data)
+{
+	(void)data;
+
+	return app_resource_index_release();
+}
+
+// the caches of this library are always reclaimed, the modules initialized on demand register their own
+static const app_reclaimer_s reclaimer_builtins[] = {
+	{ app_reclaimer_release_service, NULL, NULL },
+	{ app_reclaimer_release_resource_index, NULL, NULL },
+};
+
+int app_reclaimer_add(app_reclaimer_cb callback, void *data)
+{
+	app_reclaimer_h reclaimer_new;
+
+	if (callback == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	reclaimer_new = malloc(sizeof(app_reclaimer_s));
+
+	if (reclaimer_new == NULL)
+	{
+		return app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	reclaimer_new->callback = callback;
+	reclaimer_new->data = data;
+
+	pthread_mutex_lock(&reclaimer_lock);
+
+	reclaimer_new->next = reclaimer_head.next;
+	reclaimer_head.next = reclaimer_new;
+
+	pthread_mutex_unlock(&reclaimer_lock);
+
+	return APP_ERROR_NONE;
+}
+
+int app_reclaimer_remove(app_reclaimer_cb callback)
+{
+	app_reclaimer_h reclaimer_node = &reclaimer_head;
+	app_reclaimer_h removed_node = NULL;
+
+	pthread_mutex_lock(&reclaimer_lock);
+
+	while (reclaimer_node->next)
+	{
+		if (reclaimer_node->next->callback == callback)
+		{
+			removed_node = reclaimer_node->next;
+			reclaimer_node->next = removed_node->next;
+			break;
+		}
+
+		reclaimer_node = reclaimer_node->next;
+	}
+
+	pthread_mutex_unlock(&reclaimer_lock);
+
+	if (removed_node == NULL)
+	{
+		return APP_ERROR_INVALID_PARAMETER;
+	}
+
+	free(removed_node);
+
+	return APP_ERROR_NONE;
+}
+
+size_t app_reclaimer_execute(void)
+{
+	app_reclaimer_h reclaimer_node;
+	size_t released = 0;
+	size_t i;
+
+	for (i = 0; i < sizeof(reclaimer_builtins) / sizeof(reclaimer_builtins[0]); i++)
+	{
+		released += reclaimer_builtins[i].callback(reclaimer_builtins[i].data);
+	}
+
+	// the reclaimers must not register or remove reclaimers
+	pthread_mutex_lock(&reclaimer_lock);
+
+	for (reclaimer_node = reclaimer_head.next; reclaimer_node != NULL; reclaimer_node = reclaimer_node->next)
+	{
+		released += reclaimer_node->callback(reclaimer_node->data);
+	}
+
+	pthread_mutex_unlock(&reclaimer_lock);
+
+	LOGI("[%s] %zu bytes released", __FUNCTION__, released);
+
+	return released;
+}
+
+bool app_reclaimer_is_enabled_on_pause(void)
+{
+	return reclaimer_on_pause;
+}
+
+void app_set_reclaiming_cache_on_pause(bool enable)
+{
+	reclaimer_on_pause = enable;
+}
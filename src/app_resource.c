@@ -21,7 +21,9 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
+#include <pthread.h>
 
 #include <bundle.h>
 #include <appcore-common.h>
@@ -43,149 +45,368 @@ static const char *RO_INSTALLED_PATH = "/usr/apps";
 static const char *RES_DIRECTORY_NAME = "res";
 static const char *DATA_DIRECTORY_NAME = "data";
 
-static char * app_get_root_directory(char *buffer, int size)
+static const char *BIN_DIRECTORY_NAME = "bin";
+static const char *LOCALE_DIRECTORY_NAME = "locale";
+
+static char app_paths[APP_PATH_MAX][TIZEN_PATH_MAX];
+static int app_path_lengths[APP_PATH_MAX];
+static volatile bool app_paths_valid = false;
+static pthread_mutex_t app_paths_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// the paths never change while the process is running, so they are resolved once they can be,
+// must be called with app_paths_lock held
+static void app_init_paths(void)
 {
 	char *package = NULL;
-	char root_directory[TIZEN_PATH_MAX] = {0, };
-	char bin_directory[TIZEN_PATH_MAX] = {0, };
+	char *root_directory = app_paths[APP_PATH_ROOT];
+	char *locale_directory = app_paths[APP_PATH_LOCALE];
+	int type;
 
 	if (app_get_package(&package) != APP_ERROR_NONE)
 	{
 		app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package");
+		return;
+	}
+
+	snprintf(app_paths[APP_PATH_BIN], TIZEN_PATH_MAX, "%s/%s/%s", INSTALLED_PATH, package, BIN_DIRECTORY_NAME);
+
+	if (access(app_paths[APP_PATH_BIN], R_OK) == 0)
+	{
+		snprintf(root_directory, TIZEN_PATH_MAX, "%s/%s", INSTALLED_PATH, package);
+	}
+	else
+	{
+		snprintf(root_directory, TIZEN_PATH_MAX, "%s/%s", RO_INSTALLED_PATH, package);
+		snprintf(app_paths[APP_PATH_BIN], TIZEN_PATH_MAX, "%s/%s", root_directory, BIN_DIRECTORY_NAME);
+	}
+
+	snprintf(app_paths[APP_PATH_RES], TIZEN_PATH_MAX, "%s/%s", root_directory, RES_DIRECTORY_NAME);
+
+	// the data directory is always writable
+	snprintf(app_paths[APP_PATH_DATA], TIZEN_PATH_MAX, "%s/%s/%s", INSTALLED_PATH, package, DATA_DIRECTORY_NAME);
+
+	snprintf(locale_directory, TIZEN_PATH_MAX, "%s/%s/%s/%s", INSTALLED_PATH, package, RES_DIRECTORY_NAME, LOCALE_DIRECTORY_NAME);
+
+	if (access(locale_directory, R_OK) != 0)
+	{
+		snprintf(locale_directory, TIZEN_PATH_MAX, "%s/%s/%s/%s", RO_INSTALLED_PATH, package, RES_DIRECTORY_NAME, LOCALE_DIRECTORY_NAME);
+	}
+
+	free(package);
+
+	for (type = 0; type < APP_PATH_MAX; type++)
+	{
+		app_path_lengths[type] = strlen(app_paths[type]);
+	}
+
+	// the paths are complete before any reader sees the flag without taking the lock
+	__sync_synchronize();
+	app_paths_valid = true;
+}
+
+const char* app_get_path(app_path_type_e type)
+{
+	if (type < 0 || type >= APP_PATH_MAX)
+	{
+		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 		return NULL;
 	}
 
-	snprintf(root_directory, sizeof(root_directory), "%s/%s", INSTALLED_PATH, package);
-	snprintf(bin_directory, sizeof(bin_directory), "%s/bin", root_directory);
+	// the package is not known before appcore is set up, so a failure is retried on the next call
+	if (app_paths_valid == false)
+	{
+		pthread_mutex_lock(&app_paths_lock);
+
+		if (app_paths_valid == false)
+		{
+			app_init_paths();
+		}
 
-	if (access(bin_directory, R_OK) != 0) {
-		snprintf(root_directory, sizeof(root_directory), "%s/%s", RO_INSTALLED_PATH, package);
+		pthread_mutex_unlock(&app_paths_lock);
+
+		if (app_paths_valid == false)
+		{
+			return NULL;
+		}
 	}
 
-	free(package);	
+	__sync_synchronize();
+
+	return app_paths[type];
+}
 
-	if (size < strlen(root_directory)+1)
+char* app_get_data_directory(char *buffer, int size)
+{
+	const char *data_directory = app_get_path(APP_PATH_DATA);
+
+	if (data_directory == NULL)
+	{
+		app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the path to the data directory");
+		return NULL;
+	}
+
+	if (buffer == NULL || size < app_path_lengths[APP_PATH_DATA]+1)
 	{
 		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, "the buffer is not big enough");
 		return NULL;
 	}
 
-	snprintf(buffer, size, "%s", root_directory);
+	memcpy(buffer, data_directory, app_path_lengths[APP_PATH_DATA]+1);
 
 	return buffer;
 }
 
-static char* app_get_resource_directory(char *buffer, int size)
+char* app_get_resource(const char *resource, char *buffer, int size)
 {
-	char root_directory[TIZEN_PATH_MAX] = {0, };
-	char resource_directory[TIZEN_PATH_MAX] = {0, };
+	const char *resource_directory;
+	int resource_directory_length;
+	int resource_length;
+
+	if (resource == NULL)
+	{
+		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		return NULL;
+	}
 
-	if (app_get_root_directory(root_directory, sizeof(root_directory)) == NULL)
+	if (buffer == NULL || size <= 0)
 	{
-		app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the root directory of the application");
+		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 		return NULL;
 	}
 
-	snprintf(resource_directory, sizeof(resource_directory), "%s/%s", root_directory, RES_DIRECTORY_NAME);
+	resource_directory = app_get_path(APP_PATH_RES);
 
-	if (size < strlen(resource_directory) +1)
+	if (resource_directory == NULL)
+	{
+		app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the path to the resource directory");
+		return NULL;
+	}
+
+	resource_directory_length = app_path_lengths[APP_PATH_RES];
+	resource_length = strlen(resource);
+
+	if (size < resource_directory_length + 1 + resource_length + 1)
 	{
 		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, "the buffer is not big enough");
 		return NULL;
 	}
 
-	snprintf(buffer, size, "%s", resource_directory);
+	memcpy(buffer, resource_directory, resource_directory_length);
+	buffer[resource_directory_length] = '/';
+	memcpy(buffer + resource_directory_length + 1, resource, resource_length + 1);
+
+	app_prefetch_record(resource);
 
 	return buffer;
 }
 
-char* app_get_data_directory(char *buffer, int size)
+struct app_resource_map_s {
+	char *resource;
+	void *data;
+	size_t size;
+	int ref_count;
+	struct app_resource_map_s *next;
+};
+
+// the mappings of the same resource are shared
+static struct app_resource_map_s *resource_maps = NULL;
+static pthread_mutex_t resource_maps_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static bool app_resource_is_contained(const char *resource)
 {
-	static char data_directory[TIZEN_PATH_MAX] = {0, };
-	static int data_directory_length = 0;
+	const char *segment = resource;
 
-	if (data_directory[0] == '\0')
+	if (resource[0] == '\0' || resource[0] == '/')
 	{
-		char *root_directory = NULL;
-		char *package = NULL;
+		return false;
+	}
 
-		root_directory = calloc(1, TIZEN_PATH_MAX);
+	// no segment may go up out of the resource directory
+	while (segment != NULL)
+	{
+		if (!strncmp(segment, "..", 2) && (segment[2] == '/' || segment[2] == '\0'))
+		{
+			return false;
+		}
 
-		if (root_directory == NULL)
+		segment = strchr(segment, '/');
+
+		if (segment != NULL)
 		{
-			app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
-			return NULL;
+			segment++;
 		}
+	}
+
+	return true;
+}
 
-		if (app_get_package(&package) != APP_ERROR_NONE)
+static void app_resource_advise(void *data, size_t size, int hints)
+{
+	if (data == NULL)
+	{
+		return;
+	}
+
+	if (hints & APP_RESOURCE_MAP_HINT_SEQUENTIAL)
+	{
+		madvise(data, size, MADV_SEQUENTIAL);
+	}
+
+	if (hints & APP_RESOURCE_MAP_HINT_WILLNEED)
+	{
+		madvise(data, size, MADV_WILLNEED);
+	}
+}
+
+int app_resource_map(const char *resource, int hints, app_resource_map_h *map)
+{
+	char path[TIZEN_PATH_MAX] = {0, };
+	struct app_resource_map_s *map_new;
+	struct stat st;
+	void *data = NULL;
+	int fd;
+
+	if (resource == NULL || map == NULL || app_resource_is_contained(resource) == false)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	pthread_mutex_lock(&resource_maps_lock);
+
+	for (map_new = resource_maps; map_new != NULL; map_new = map_new->next)
+	{
+		if (!strcmp(map_new->resource, resource))
 		{
-			app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the package");
-			return NULL;
+			map_new->ref_count++;
+			pthread_mutex_unlock(&resource_maps_lock);
+
+			app_resource_advise(map_new->data, map_new->size, hints);
+
+			*map = map_new;
+			return APP_ERROR_NONE;
 		}
+	}
 
-		snprintf(root_directory, TIZEN_PATH_MAX, "%s/%s", INSTALLED_PATH, package);
+	pthread_mutex_unlock(&resource_maps_lock);
 
-		free(package);
+	if (app_get_resource(resource, path, sizeof(path)) == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the path to the resource");
+	}
 
-		snprintf(data_directory, sizeof(data_directory), "%s/%s", root_directory, DATA_DIRECTORY_NAME);
+	fd = open(path, O_RDONLY | O_CLOEXEC);
 
-		data_directory_length = strlen(data_directory);
+	if (fd < 0)
+	{
+		return app_error(APP_ERROR_NO_SUCH_FILE, __FUNCTION__, resource);
+	}
 
-		free(root_directory);
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		close(fd);
+		return app_error(APP_ERROR_NO_SUCH_FILE, __FUNCTION__, resource);
 	}
 
-	if (size < data_directory_length+1)
+	// an empty file cannot be mapped
+	if (st.st_size > 0)
 	{
-		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, "the buffer is not big enough");
-		return NULL;
+		data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
 	}
 
-	snprintf(buffer, size, "%s", data_directory);
+	close(fd);
 
-	return buffer;
-}
+	if (data == MAP_FAILED)
+	{
+		return app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to map the resource");
+	}
 
-char* app_get_resource(const char *resource, char *buffer, int size)
-{
-	static char resource_directory[TIZEN_PATH_MAX] = {0, };
-	static int resource_directory_length = 0;
+	app_resource_advise(data, st.st_size, hints);
 
-	int resource_path_length = 0;
+	map_new = calloc(1, sizeof(struct app_resource_map_s));
 
-	if (resource == NULL)
+	if (map_new == NULL || (map_new->resource = strdup(resource)) == NULL)
 	{
-		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-		return NULL;
+		free(map_new);
+
+		if (data != NULL)
+		{
+			munmap(data, st.st_size);
+		}
+
+		return app_error(APP_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
 	}
 
-	if (buffer == NULL || size <= 0)
+	map_new->data = data;
+	map_new->size = st.st_size;
+	map_new->ref_count = 1;
+
+	pthread_mutex_lock(&resource_maps_lock);
+	map_new->next = resource_maps;
+	resource_maps = map_new;
+	pthread_mutex_unlock(&resource_maps_lock);
+
+	*map = map_new;
+
+	return APP_ERROR_NONE;
+}
+
+int app_resource_map_get_data(app_resource_map_h map, const void **data, size_t *size)
+{
+	if (map == NULL || data == NULL || size == NULL)
 	{
-		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-		return NULL;
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	if (resource_directory[0] == '\0')
+	*data = map->data;
+	*size = map->size;
+
+	return APP_ERROR_NONE;
+}
+
+int app_resource_unmap(app_resource_map_h map)
+{
+	struct app_resource_map_s **node;
+
+	if (map == NULL)
 	{
-		if (app_get_resource_directory(resource_directory, sizeof(resource_directory)) == NULL)
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	pthread_mutex_lock(&resource_maps_lock);
+
+	for (node = &resource_maps; *node != NULL; node = &(*node)->next)
+	{
+		if (*node == map)
 		{
-			app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to get the path to the resource directory");
-			return NULL;
+			break;
 		}
+	}
 
-		resource_directory_length = strlen(resource_directory);
+	if (*node == NULL)
+	{
+		pthread_mutex_unlock(&resource_maps_lock);
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, "the mapping has already been released");
+	}
+
+	if (--map->ref_count > 0)
+	{
+		pthread_mutex_unlock(&resource_maps_lock);
+		return APP_ERROR_NONE;
 	}
 
-	resource_path_length = resource_directory_length + strlen("/") + strlen(resource);
+	*node = map->next;
 
-	if (size < resource_path_length+1)
+	pthread_mutex_unlock(&resource_maps_lock);
+
+	if (map->data != NULL)
 	{
-		app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, "the buffer is not big enough");
-		return NULL;
+		munmap(map->data, map->size);
 	}
 
-	snprintf(buffer, size, "%s/%s", resource_directory, resource);
+	free(map->resource);
+	free(map);
 
-	return buffer;
+	return APP_ERROR_NONE;
 }
 
 
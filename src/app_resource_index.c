@@ -0,0 +1,684 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+
+#include <dlog.h>
+
+#include <app_private.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_APPLICATION"
+
+#define RESOURCE_INDEX_MAGIC "RIDX"
+#define RESOURCE_INDEX_VERSION 2
+#define RESOURCE_INDEX_CACHE_NAME ".resource_index"
+
+#define RESOURCE_INDEX_FLAG_DIRECTORY 0x1
+
+/*
+ * The index is a single blob so that the cache file can be used as is once mapped:
+ * header | entries | buckets | strings
+ * The buckets form an open addressing hash table of entry indexes plus one, 0 means empty.
+ * The cache is validated by the modification time of the binary directory, which changes when the package is
+ * installed again, and those of the indexed directories, which change when a resource is added, removed or renamed.
+ */
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t bucket_count;
+	uint32_t strings_size;
+	uint32_t reserved;
+	uint64_t size;
+	int64_t install_mtime;
+	int64_t install_mtime_nsec;
+} resource_index_header_s;
+
+typedef struct {
+	uint32_t hash;
+	uint32_t path;
+	uint32_t flags;
+	uint32_t reserved;
+	uint64_t size;
+	int64_t mtime;
+	int64_t mtime_nsec;
+} resource_index_entry_s;
+
+typedef struct {
+	resource_index_entry_s *entries;
+	uint32_t entry_count;
+	uint32_t entry_capacity;
+	char *strings;
+	uint32_t strings_size;
+	uint32_t strings_capacity;
+} resource_index_builder_s;
+
+static const resource_index_header_s *resource_index = NULL;
+static bool resource_index_mapped = false;
+static bool resource_index_cache_enabled = false;
+static pthread_mutex_t resource_index_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t resource_index_hash(const char *path)
+{
+	uint32_t hash = 2166136261u;
+
+	while (*path)
+	{
+		hash ^= (unsigned char)*path++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static const resource_index_entry_s* resource_index_entries(const resource_index_header_s *index)
+{
+	return (const resource_index_entry_s *)(index + 1);
+}
+
+static const uint32_t* resource_index_buckets(const resource_index_header_s *index)
+{
+	return (const uint32_t *)(resource_index_entries(index) + index->entry_count);
+}
+
+static const char* resource_index_strings(const resource_index_header_s *index)
+{
+	return (const char *)(resource_index_buckets(index) + index->bucket_count);
+}
+
+static int resource_index_builder_add(resource_index_builder_s *builder, const char *path, const struct stat *st)
+{
+	resource_index_entry_s *entry;
+	size_t length = strlen(path) + 1;
+
+	if (builder->entry_count == builder->entry_capacity)
+	{
+		uint32_t capacity = builder->entry_capacity ? builder->entry_capacity * 2 : 64;
+		resource_index_entry_s *entries = realloc(builder->entries, sizeof(resource_index_entry_s) * capacity);
+
+		if (entries == NULL)
+		{
+			return APP_ERROR_OUT_OF_MEMORY;
+		}
+
+		builder->entries = entries;
+		builder->entry_capacity = capacity;
+	}
+
+	if (builder->strings_size + length > builder->strings_capacity)
+	{
+		uint32_t capacity = builder->strings_capacity ? builder->strings_capacity : 1024;
+		char *strings;
+
+		while (builder->strings_size + length > capacity)
+		{
+			capacity *= 2;
+		}
+
+		strings = realloc(builder->strings, capacity);
+
+		if (strings == NULL)
+		{
+			return APP_ERROR_OUT_OF_MEMORY;
+		}
+
+		builder->strings = strings;
+		builder->strings_capacity = capacity;
+	}
+
+	entry = &builder->entries[builder->entry_count++];
+	memset(entry, 0, sizeof(resource_index_entry_s));
+	entry->hash = resource_index_hash(path);
+	entry->path = builder->strings_size;
+	entry->flags = S_ISDIR(st->st_mode) ? RESOURCE_INDEX_FLAG_DIRECTORY : 0;
+	entry->size = st->st_size;
+	entry->mtime = st->st_mtim.tv_sec;
+	entry->mtime_nsec = st->st_mtim.tv_nsec;
+
+	memcpy(builder->strings + builder->strings_size, path, length);
+	builder->strings_size += length;
+
+	return APP_ERROR_NONE;
+}
+
+// path is relative to the resource directory, and the empty string is the resource directory itself
+static int resource_index_scan(resource_index_builder_s *builder, int dir_fd, const char *path)
+{
+	char child_path[TIZEN_PATH_MAX];
+	struct dirent *dentry;
+	struct stat st;
+	DIR *dir;
+	bool is_link;
+	int child_fd;
+	int retval = APP_ERROR_NONE;
+
+	dir = fdopendir(dir_fd);
+
+	if (dir == NULL)
+	{
+		close(dir_fd);
+		return APP_ERROR_NO_SUCH_FILE;
+	}
+
+	while (retval == APP_ERROR_NONE && (dentry = readdir(dir)) != NULL)
+	{
+		if (!strcmp(dentry->d_name, ".") || !strcmp(dentry->d_name, ".."))
+		{
+			continue;
+		}
+
+		if (fstatat(dirfd(dir), dentry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+		{
+			continue;
+		}
+
+		// a link is indexed as what it points to, but never descended into, so that a loop cannot recurse
+		is_link = S_ISLNK(st.st_mode);
+
+		if (is_link == true && fstatat(dirfd(dir), dentry->d_name, &st, 0) != 0)
+		{
+			continue;
+		}
+
+		if (path[0] == '\0')
+		{
+			snprintf(child_path, sizeof(child_path), "%s", dentry->d_name);
+		}
+		else
+		{
+			snprintf(child_path, sizeof(child_path), "%s/%s", path, dentry->d_name);
+		}
+
+		retval = resource_index_builder_add(builder, child_path, &st);
+
+		if (retval == APP_ERROR_NONE && S_ISDIR(st.st_mode) && is_link == false)
+		{
+			child_fd = openat(dirfd(dir), dentry->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+
+			if (child_fd >= 0)
+			{
+				retval = resource_index_scan(builder, child_fd, child_path);
+			}
+		}
+	}
+
+	closedir(dir);
+
+	return retval;
+}
+
+// a missing binary directory is recorded as the zero time, so that it is still compared
+static void resource_index_install_time(const char *install_directory, int64_t *mtime, int64_t *mtime_nsec)
+{
+	struct stat st;
+
+	*mtime = 0;
+	*mtime_nsec = 0;
+
+	if (install_directory != NULL && stat(install_directory, &st) == 0)
+	{
+		*mtime = st.st_mtim.tv_sec;
+		*mtime_nsec = st.st_mtim.tv_nsec;
+	}
+}
+
+static resource_index_header_s* resource_index_build(const char *resource_directory, const char *install_directory)
+{
+	resource_index_builder_s builder = {0, };
+	resource_index_header_s *index = NULL;
+	resource_index_entry_s *entries;
+	uint32_t *buckets;
+	uint32_t bucket_count = 16;
+	uint32_t bucket;
+	uint32_t i;
+	size_t size;
+	struct stat st;
+	int dir_fd;
+
+	dir_fd = open(resource_directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (dir_fd < 0 || fstat(dir_fd, &st) != 0)
+	{
+		if (dir_fd >= 0)
+		{
+			close(dir_fd);
+		}
+
+		return NULL;
+	}
+
+	// the resource directory itself is recorded first to validate the cache
+	if (resource_index_builder_add(&builder, "", &st) != APP_ERROR_NONE)
+	{
+		close(dir_fd);
+		goto out;
+	}
+
+	if (resource_index_scan(&builder, dir_fd, "") != APP_ERROR_NONE)
+	{
+		goto out;
+	}
+
+	while (bucket_count < builder.entry_count * 2)
+	{
+		bucket_count *= 2;
+	}
+
+	size = sizeof(resource_index_header_s) + sizeof(resource_index_entry_s) * builder.entry_count
+		+ sizeof(uint32_t) * bucket_count + builder.strings_size;
+
+	index = calloc(1, size);
+
+	if (index == NULL)
+	{
+		goto out;
+	}
+
+	memcpy(index->magic, RESOURCE_INDEX_MAGIC, sizeof(index->magic));
+	index->version = RESOURCE_INDEX_VERSION;
+	index->entry_count = builder.entry_count;
+	index->bucket_count = bucket_count;
+	index->strings_size = builder.strings_size;
+	index->size = size;
+	resource_index_install_time(install_directory, &index->install_mtime, &index->install_mtime_nsec);
+
+	entries = (resource_index_entry_s *)resource_index_entries(index);
+	buckets = (uint32_t *)resource_index_buckets(index);
+
+	memcpy(entries, builder.entries, sizeof(resource_index_entry_s) * builder.entry_count);
+	memcpy((char *)resource_index_strings(index), builder.strings, builder.strings_size);
+
+	for (i = 0; i < builder.entry_count; i++)
+	{
+		bucket = entries[i].hash & (bucket_count - 1);
+
+		while (buckets[bucket] != 0)
+		{
+			bucket = (bucket + 1) & (bucket_count - 1);
+		}
+
+		buckets[bucket] = i + 1;
+	}
+
+out:
+	free(builder.entries);
+	free(builder.strings);
+
+	return index;
+}
+
+static const resource_index_entry_s* resource_index_lookup(const resource_index_header_s *index, const char *path)
+{
+	const resource_index_entry_s *entries = resource_index_entries(index);
+	const uint32_t *buckets = resource_index_buckets(index);
+	const char *strings = resource_index_strings(index);
+	uint32_t hash = resource_index_hash(path);
+	uint32_t bucket = hash & (index->bucket_count - 1);
+	uint32_t probe;
+
+	// the table always has an empty bucket, the probes are bounded nevertheless
+	for (probe = 0; probe < index->bucket_count && buckets[bucket] != 0; probe++)
+	{
+		const resource_index_entry_s *entry = &entries[buckets[bucket] - 1];
+
+		if (entry->hash == hash && !strcmp(strings + entry->path, path))
+		{
+			return entry;
+		}
+
+		bucket = (bucket + 1) & (index->bucket_count - 1);
+	}
+
+	return NULL;
+}
+
+// the cache is valid if it is well formed, the package has not been installed again and no resource has been added, removed or renamed
+static bool resource_index_validate(const resource_index_header_s *index, size_t size, const char *resource_directory, const char *install_directory)
+{
+	const resource_index_entry_s *entries;
+	const uint32_t *buckets;
+	const char *strings;
+	char path[TIZEN_PATH_MAX];
+	struct stat st;
+	int64_t install_mtime;
+	int64_t install_mtime_nsec;
+	uint32_t empty_buckets = 0;
+	uint32_t i;
+
+	if (size < sizeof(resource_index_header_s)
+		|| memcmp(index->magic, RESOURCE_INDEX_MAGIC, sizeof(index->magic))
+		|| index->version != RESOURCE_INDEX_VERSION
+		|| index->size != size
+		|| index->entry_count == 0
+		|| index->bucket_count == 0 || (index->bucket_count & (index->bucket_count - 1)) != 0
+		|| sizeof(resource_index_header_s) + sizeof(resource_index_entry_s) * (uint64_t)index->entry_count
+			+ sizeof(uint32_t) * (uint64_t)index->bucket_count + index->strings_size != size)
+	{
+		return false;
+	}
+
+	entries = resource_index_entries(index);
+	buckets = resource_index_buckets(index);
+	strings = resource_index_strings(index);
+
+	if (index->strings_size == 0 || strings[index->strings_size - 1] != '\0')
+	{
+		return false;
+	}
+
+	// a bucket out of range would be read out of the mapping, a full table would make the lookups probe forever
+	for (i = 0; i < index->bucket_count; i++)
+	{
+		if (buckets[i] > index->entry_count)
+		{
+			return false;
+		}
+
+		if (buckets[i] == 0)
+		{
+			empty_buckets++;
+		}
+	}
+
+	if (empty_buckets == 0)
+	{
+		return false;
+	}
+
+	for (i = 0; i < index->entry_count; i++)
+	{
+		if (entries[i].path >= index->strings_size)
+		{
+			return false;
+		}
+	}
+
+	resource_index_install_time(install_directory, &install_mtime, &install_mtime_nsec);
+
+	if (install_mtime != index->install_mtime || install_mtime_nsec != index->install_mtime_nsec)
+	{
+		return false;
+	}
+
+	// only the directories are checked, so a hit costs far fewer system calls than the scan
+	for (i = 0; i < index->entry_count; i++)
+	{
+		if (!(entries[i].flags & RESOURCE_INDEX_FLAG_DIRECTORY))
+		{
+			continue;
+		}
+
+		snprintf(path, sizeof(path), "%s/%s", resource_directory, strings + entries[i].path);
+
+		if (stat(path, &st) != 0 || st.st_mtim.tv_sec != entries[i].mtime || st.st_mtim.tv_nsec != entries[i].mtime_nsec)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static const resource_index_header_s* resource_index_map_cache(const char *cache_path, const char *resource_directory, const char *install_directory)
+{
+	void *mapped;
+	struct stat st;
+	int fd;
+
+	fd = open(cache_path, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		return NULL;
+	}
+
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(resource_index_header_s))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapped == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	if (resource_index_validate(mapped, st.st_size, resource_directory, install_directory) == false)
+	{
+		LOGI("[%s] the resource index cache is out of date", __FUNCTION__);
+		munmap(mapped, st.st_size);
+		return NULL;
+	}
+
+	return mapped;
+}
+
+static void resource_index_write_cache(const char *cache_path, const resource_index_header_s *index)
+{
+	char temp_path[TIZEN_PATH_MAX];
+	int fd;
+
+	snprintf(temp_path, sizeof(temp_path), "%s.%d", cache_path, getpid());
+
+	fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+
+	if (fd < 0)
+	{
+		return;
+	}
+
+	if (write(fd, index, index->size) != (ssize_t)index->size || close(fd) != 0 || rename(temp_path, cache_path) != 0)
+	{
+		LOGW("[%s] failed to write the resource index cache", __FUNCTION__);
+		unlink(temp_path);
+	}
+}
+
+static const resource_index_header_s* resource_index_get(void)
+{
+	const char *resource_directory;
+	const char *data_directory;
+	const char *install_directory;
+	char cache_path[TIZEN_PATH_MAX] = {0, };
+	resource_index_header_s *index;
+
+	if (resource_index != NULL)
+	{
+		return resource_index;
+	}
+
+	resource_directory = app_get_path(APP_PATH_RES);
+	data_directory = app_get_path(APP_PATH_DATA);
+	install_directory = app_get_path(APP_PATH_BIN);
+
+	if (resource_directory == NULL || data_directory == NULL)
+	{
+		return NULL;
+	}
+
+	if (resource_index_cache_enabled == true)
+	{
+		snprintf(cache_path, sizeof(cache_path), "%s/%s", data_directory, RESOURCE_INDEX_CACHE_NAME);
+
+		resource_index = resource_index_map_cache(cache_path, resource_directory, install_directory);
+
+		if (resource_index != NULL)
+		{
+			resource_index_mapped = true;
+			return resource_index;
+		}
+	}
+
+	index = resource_index_build(resource_directory, install_directory);
+
+	if (index == NULL)
+	{
+		app_error(APP_ERROR_NO_SUCH_FILE, __FUNCTION__, "failed to scan the resource directory");
+		return NULL;
+	}
+
+	if (resource_index_cache_enabled == true)
+	{
+		resource_index_write_cache(cache_path, index);
+	}
+
+	resource_index = index;
+	resource_index_mapped = false;
+
+	return resource_index;
+}
+
+void app_set_resource_index_cache(bool enable)
+{
+	pthread_mutex_lock(&resource_index_lock);
+	resource_index_cache_enabled = enable;
+	pthread_mutex_unlock(&resource_index_lock);
+}
+
+int app_resource_index_load(void)
+{
+	const resource_index_header_s *index;
+
+	pthread_mutex_lock(&resource_index_lock);
+	index = resource_index_get();
+	pthread_mutex_unlock(&resource_index_lock);
+
+	if (index == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "failed to load the resource index");
+	}
+
+	return APP_ERROR_NONE;
+}
+
+size_t app_resource_index_release(void)
+{
+	size_t released = 0;
+
+	pthread_mutex_lock(&resource_index_lock);
+
+	if (resource_index != NULL)
+	{
+		released = resource_index->size;
+
+		if (resource_index_mapped == true)
+		{
+			munmap((void *)resource_index, resource_index->size);
+		}
+		else
+		{
+			free((void *)resource_index);
+		}
+
+		resource_index = NULL;
+	}
+
+	pthread_mutex_unlock(&resource_index_lock);
+
+	return released;
+}
+
+static int app_resource_index_find(const char *resource, const char *function, bool *found, size_t *size)
+{
+	const resource_index_header_s *index;
+	const resource_index_entry_s *entry;
+
+	if (resource == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, function, NULL);
+	}
+
+	pthread_mutex_lock(&resource_index_lock);
+
+	index = resource_index_get();
+
+	if (index == NULL)
+	{
+		pthread_mutex_unlock(&resource_index_lock);
+		return app_error(APP_ERROR_INVALID_CONTEXT, function, "failed to load the resource index");
+	}
+
+	while (resource[0] == '/')
+	{
+		resource++;
+	}
+
+	entry = resource_index_lookup(index, resource);
+
+	*found = (entry != NULL && !(entry->flags & RESOURCE_INDEX_FLAG_DIRECTORY));
+
+	if (*found == true && size != NULL)
+	{
+		*size = entry->size;
+	}
+
+	pthread_mutex_unlock(&resource_index_lock);
+
+	return APP_ERROR_NONE;
+}
+
+int app_resource_exists(const char *resource, bool *exists)
+{
+	if (exists == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	return app_resource_index_find(resource, __FUNCTION__, exists, NULL);
+}
+
+int app_resource_get_size(const char *resource, size_t *size)
+{
+	bool found = false;
+	int retval;
+
+	if (size == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	retval = app_resource_index_find(resource, __FUNCTION__, &found, size);
+
+	if (retval != APP_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	if (found == false)
+	{
+		return app_error(APP_ERROR_NO_SUCH_FILE, __FUNCTION__, resource);
+	}
+
+	return APP_ERROR_NONE;
+}
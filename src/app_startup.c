@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dlog.h>
+
+#include <app_private.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_APPLICATION"
+
+#define APP_STARTUP_PROFILE_ENV "CAPI_APPFW_STARTUP_PROFILE"
+
+typedef struct {
+	struct timespec begin;
+	struct timespec end;
+	bool recorded;
+} app_startup_phase_s;
+
+// the phases are recorded once from the main thread before the main loop runs
+static app_startup_phase_s startup_phases[APP_STARTUP_PHASE_MAX];
+
+static const char* app_startup_phase_to_string(app_startup_phase_e phase)
+{
+	switch (phase)
+	{
+	case APP_STARTUP_PHASE_GET_PACKAGE:
+		return "GET_PACKAGE";
+
+	case APP_STARTUP_PHASE_GET_APP_NAME:
+		return "GET_APP_NAME";
+
+	case APP_STARTUP_PHASE_APPCORE_INIT:
+		return "APPCORE_INIT";
+
+	case APP_STARTUP_PHASE_LOCALE_PROBE:
+		return "LOCALE_PROBE";
+
+	case APP_STARTUP_PHASE_I18N:
+		return "I18N";
+
+	case APP_STARTUP_PHASE_CREATE_CB:
+		return "CREATE_CB";
+
+	default :
+		return "UNKNOWN";
+	}
+}
+
+static long long app_startup_elapsed_us(const struct timespec *from, const struct timespec *to)
+{
+	return (to->tv_sec - from->tv_sec) * 1000000LL + (to->tv_nsec - from->tv_nsec) / 1000;
+}
+
+void app_startup_phase_begin(app_startup_phase_e phase)
+{
+	if (phase < 0 || phase >= APP_STARTUP_PHASE_MAX)
+	{
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &startup_phases[phase].begin);
+	startup_phases[phase].recorded = false;
+}
+
+void app_startup_phase_end(app_startup_phase_e phase)
+{
+	if (phase < 0 || phase >= APP_STARTUP_PHASE_MAX)
+	{
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &startup_phases[phase].end);
+	startup_phases[phase].recorded = true;
+}
+
+void app_startup_dump(void)
+{
+	const char *env = getenv(APP_STARTUP_PROFILE_ENV);
+	const struct timespec *origin = NULL;
+	int phase;
+
+	if (env == NULL || env[0] != '1')
+	{
+		return;
+	}
+
+	for (phase = 0; phase < APP_STARTUP_PHASE_MAX; phase++)
+	{
+		if (startup_phases[phase].recorded == false)
+		{
+			continue;
+		}
+
+		// the offsets are relative to the first recorded phase
+		if (origin == NULL)
+		{
+			origin = &startup_phases[phase].begin;
+		}
+
+		LOGI("[startup] %-12s +%lldus %lldus", app_startup_phase_to_string(phase),
+			app_startup_elapsed_us(origin, &startup_phases[phase].begin),
+			app_startup_elapsed_us(&startup_phases[phase].begin, &startup_phases[phase].end));
+	}
+}
+
+int app_get_startup_phase(app_startup_phase_e phase, struct timespec *begin, struct timespec *end)
+{
+	if (phase < 0 || phase >= APP_STARTUP_PHASE_MAX || begin == NULL || end == NULL)
+	{
+		return app_error(APP_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (startup_phases[phase].recorded == false)
+	{
+		return app_error(APP_ERROR_INVALID_CONTEXT, __FUNCTION__, "the phase has not been completed");
+	}
+
+	*begin = startup_phases[phase].begin;
+	*end = startup_phases[phase].end;
+
+	return APP_ERROR_NONE;
+}
@@ -19,11 +19,68 @@
 #include <stdlib.h>
 #include <string.h>
 #include <libintl.h>
+#include <pthread.h>
 
+#include <app_private.h>
 #include <app_i18n.h>
 
+static app_i18n_init_cb i18n_pending_init = NULL;
+static void *i18n_pending_init_data = NULL;
+static volatile bool i18n_init_pending = false;
+static volatile bool i18n_init_running = false;
+static pthread_t i18n_init_thread;
+static pthread_mutex_t i18n_init_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void app_i18n_defer_init(app_i18n_init_cb callback, void *data)
+{
+	pthread_mutex_lock(&i18n_init_lock);
+	i18n_pending_init = callback;
+	i18n_pending_init_data = data;
+	i18n_init_pending = (callback != NULL);
+	pthread_mutex_unlock(&i18n_init_lock);
+}
+
+void app_i18n_run_pending_init(void)
+{
+	app_i18n_init_cb init_cb;
+
+	if (i18n_init_pending == false)
+	{
+		return;
+	}
+
+	// the setup itself may look up translations
+	if (i18n_init_running == true && pthread_equal(i18n_init_thread, pthread_self()))
+	{
+		return;
+	}
+
+	// the other callers wait until the locale binding is set up
+	pthread_mutex_lock(&i18n_init_lock);
+
+	init_cb = i18n_pending_init;
+
+	if (init_cb != NULL)
+	{
+		i18n_init_thread = pthread_self();
+		i18n_init_running = true;
+
+		init_cb(i18n_pending_init_data);
+
+		i18n_init_running = false;
+		i18n_pending_init = NULL;
+		i18n_pending_init_data = NULL;
+	}
+
+	i18n_init_pending = false;
+
+	pthread_mutex_unlock(&i18n_init_lock);
+}
+
 char* i18n_get_text(const char *message)
 {
+	app_i18n_run_pending_init();
+
 	return gettext(message);
 }
 
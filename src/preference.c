@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <limits.h>
 #include <sqlite3.h>
 
 #include <app_private.h>
@@ -39,8 +40,19 @@ static sqlite3 *pref_db = NULL;
 static bool is_update_hook_registered = false;
 static pref_changed_cb_node_t *head = NULL;
 
+static size_t _release_memory(void *data)
+{
+	int released = sqlite3_release_memory(INT_MAX);
+
+	(void)data;
+
+	return released > 0 ? released : 0;
+}
+
 static void _finish(void *data)
 {
+	app_reclaimer_remove(_release_memory);
+
 	if (pref_db != NULL)
 	{
 		sqlite3_close(pref_db);
@@ -81,7 +93,9 @@ static int _initialize(void)
 		return PREFERENCE_ERROR_IO_ERROR;
 	}
 
-	app_finalizer_add(_finish, NULL);
+	// the database is closed before the other finalizers run, and even when the shutdown budget is spent
+	app_finalizer_add_with_priority(_finish, NULL, APP_FINALIZER_PRIORITY_CRITICAL);
+	app_reclaimer_add(_release_memory, NULL);
 
 	return PREFERENCE_ERROR_NONE;
 }
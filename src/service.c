@@ -20,12 +20,22 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 #include <bundle.h>
 #include <aul.h>
 #include <appsvc.h>
 #include <dlog.h>
 
+#include <Ecore.h>
+
 #include <app_service.h>
 #include <app_service_private.h>
 
@@ -48,7 +58,31 @@
 #define BUNDLE_KEY_DATA		"__APP_SVC_DATA__"
 #define BUNDLE_KEY_PACKAGE	"__APP_SVC_PKG_NAME__"
 #define BUNDLE_KEY_WINDOW	"__APP_SVC_K_WIN_ID__"
+#define BUNDLE_KEY_PREFIX_SHM	"__APP_SVC_SHM__"
+#define BUNDLE_KEY_CALLER_TOKEN	"__APP_SVC_CALLER_TOKEN__"
+
+#define SERVICE_SHM_NAME_FMT "/capi-appfw-service-%d-%u-%016llx"
+#define SERVICE_SHM_NAME_SIZE 64
+#define SERVICE_SHM_RELEASE_TIMEOUT 60
+
+#define SERVICE_ENCODING_MAGIC "SVCB"
+#define SERVICE_ENCODING_VERSION 1
+#define SERVICE_ENCODING_HEADER_SIZE 12
+
+#define SERVICE_APP_INFO_DB_PATH "/opt/dbspace/.app_info.db"
+#define SERVICE_APPSVC_DB_PATH "/opt/dbspace/.appsvc.db"
+#define SERVICE_APP_MATCHED_CACHE_SIZE 8
+#define SERVICE_CALLER_CACHE_SIZE 16
 
+#define SERVICE_HANDLE_POOL_SIZE 8
+#define SERVICE_CALLER_ID_INLINE_SIZE 128
+
+
+typedef enum {
+	SERVICE_ENCODING_TYPE_STR = 1,
+	SERVICE_ENCODING_TYPE_STR_ARRAY = 2,
+	SERVICE_ENCODING_TYPE_BYTE = 3,
+} service_encoding_type_e;
 
 typedef enum {
 	SERVICE_TYPE_REQUEST,
@@ -56,21 +90,91 @@ typedef enum {
 	SERVICE_TYPE_REPLY,
 } service_type_e;
 
+typedef struct service_shm_mapping_s {
+	char *key;
+	void *addr;
+	size_t size;
+	struct service_shm_mapping_s *next;
+} service_shm_mapping_s;
+
+// a segment is owned by the handle that created it and shared by its clones, the last one unlinks it
+typedef struct service_shm_segment_s {
+	int ref;
+	int sent;
+	char name[SERVICE_SHM_NAME_SIZE];
+} service_shm_segment_s;
+
+typedef struct service_shm_owned_s {
+	char *key;
+	service_shm_segment_s *segment;
+	struct service_shm_owned_s *next;
+} service_shm_owned_s;
+
+// the segments sent to another application, unlinked if the receiver has not done it in time
+typedef struct service_shm_pending_s {
+	char name[SERVICE_SHM_NAME_SIZE];
+	Ecore_Timer *timer;
+	struct service_shm_pending_s *next;
+} service_shm_pending_s;
+
 struct service_s {
 	int id;
 	service_type_e type;
 	bundle *data;
+	bool data_borrowed;
+	char *caller_id;
+	char caller_id_buf[SERVICE_CALLER_ID_INLINE_SIZE];
+	service_shm_mapping_s *shm_mappings;
+	service_shm_owned_s *shm_owned;
+	struct service_s *pool_next;
 };
 
+static struct service_s *service_pool_head = NULL;
+static int service_pool_count = 0;
+static pthread_mutex_t service_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
 typedef struct service_request_context_s {
+	int request_id;
 	service_h service;
 	service_reply_cb reply_cb;
 	void *user_data;
+	struct timespec created;
+	Ecore_Timer *timer;
+	struct service_request_context_s *prev;
+	struct service_request_context_s *next;
 } *service_request_context_h;
 
+typedef struct service_launch_context_s {
+	service_h service;
+	service_request_context_h request_context;
+	service_launch_cb launch_cb;
+	void *user_data;
+	int request_id;
+	int launch_pid;
+} *service_launch_context_h;
+
+static pthread_mutex_t service_launch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static service_request_context_h service_pending_requests = NULL;
+static int service_request_timeout = 0;
+static pthread_mutex_t service_pending_requests_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static service_shm_pending_s *service_shm_pending = NULL;
+static pthread_mutex_t service_shm_pending_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t service_shm_pending_once = PTHREAD_ONCE_INIT;
+
+static char *service_local_app_id = NULL;
+static service_local_dispatch_cb service_local_dispatcher = NULL;
+static void *service_local_dispatcher_data = NULL;
+static pthread_mutex_t service_local_dispatcher_lock = PTHREAD_MUTEX_INITIALIZER;
+
 extern int appsvc_allow_transient_app(bundle *b, unsigned int id);
 
 static int service_create_reply(bundle *data, struct service_s **service);
+static struct service_s* service_alloc(service_type_e type);
+static void service_destroy_request_context(service_request_context_h request_context);
+static service_request_context_h service_unregister_request_context(int request_id);
+static void service_complete_request_context(service_request_context_h request_context, bundle *reply_data, service_result_e result);
 
 static const char* service_error_to_string(service_error_e error)
 {
@@ -138,8 +242,60 @@ static int service_valiate_service(service_h service)
 
 static int service_new_id()
 {
-	static int sid = 0;
-	return sid++;
+	static unsigned int sid = 0;
+
+	// handles can be created from any thread, and the id wraps around to 0 instead of going negative
+	return (int)(__sync_fetch_and_add(&sid, 1) & INT_MAX);
+}
+
+static int service_read_random(void *buffer, size_t size)
+{
+	ssize_t length;
+	int fd;
+
+	fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	length = read(fd, buffer, size);
+	close(fd);
+
+	return length == (ssize_t)size ? 0 : -1;
+}
+
+static unsigned long long service_caller_token = 0;
+static pthread_once_t service_caller_token_once = PTHREAD_ONCE_INIT;
+
+static void service_caller_token_init(void)
+{
+	// without a token, the callee tells a reused pid apart by the start time of the process
+	if (service_read_random(&service_caller_token, sizeof(service_caller_token)) != 0)
+	{
+		service_caller_token = 0;
+	}
+}
+
+// the random token of the process lets the callee reuse the caller it resolved for the same pid
+static void service_caller_token_attach(bundle *data)
+{
+	char token[32] = {0, };
+
+	pthread_once(&service_caller_token_once, service_caller_token_init);
+
+	// the token of the process that sent a forwarded request is never passed on
+	bundle_del(data, BUNDLE_KEY_CALLER_TOKEN);
+
+	if (service_caller_token == 0)
+	{
+		return;
+	}
+
+	snprintf(token, sizeof(token), "%llx", service_caller_token);
+
+	bundle_add(data, BUNDLE_KEY_CALLER_TOKEN, token);
 }
 
 int service_validate_internal_key(const char *key)
@@ -160,27 +316,19 @@ int service_validate_internal_key(const char *key)
 static void service_request_result_broker(bundle *appsvc_bundle, int appsvc_request_code, appsvc_result_val appsvc_result, void *appsvc_data)
 {
 	service_request_context_h request_context;
-	service_h request;
-	service_h reply = NULL;
 	service_result_e result;
-	void *user_data;
-	service_reply_cb reply_cb;	
 
-	if (appsvc_data == NULL)
-	{
-		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid service reply");
-		return;
-	}
+	(void)appsvc_data;
+
+	// the request has been completed already if it was expired or canceled
+	request_context = service_unregister_request_context(appsvc_request_code);
 
-	if (service_create_reply(appsvc_bundle, &reply) != 0)
+	if (request_context == NULL)
 	{
-		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to create service reply");
-		return;		
+		LOGW("[%s] the reply to the expired request(%d) is discarded", __FUNCTION__, appsvc_request_code);
+		return;
 	}
 
-	request_context = appsvc_data;
-	request = request_context->service;
-
 	switch (appsvc_result)
 	{
 	case APPSVC_RES_OK:
@@ -200,32 +348,260 @@ static void service_request_result_broker(bundle *appsvc_bundle, int appsvc_requ
 		break;
 	}
 
-	user_data = request_context->user_data;
-	reply_cb = request_context->reply_cb;
+	// the reply does not carry the trace ID, the request is identified by its context instead
+	service_trace_record_request(getpid(), request_context->request_id, SERVICE_TRACE_STAGE_REPLY);
 
-	if (reply_cb != NULL)
+	service_complete_request_context(request_context, appsvc_bundle, result);
+}
+
+
+int service_create(service_h *service)
+{
+	return service_create_request(NULL, service);
+}
+
+// handles are recycled through a small free list, so that the short-lived event and reply handles cost no allocation
+static struct service_s* service_alloc(service_type_e type)
+{
+	struct service_s *service = NULL;
+
+	pthread_mutex_lock(&service_pool_lock);
+
+	if (service_pool_head != NULL)
 	{
-		reply_cb(request, reply, result, user_data);
+		service = service_pool_head;
+		service_pool_head = service->pool_next;
+		service_pool_count--;
 	}
-	else
+
+	pthread_mutex_unlock(&service_pool_lock);
+
+	if (service == NULL)
 	{
-		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid callback ");
+		service = malloc(sizeof(struct service_s));
+
+		if (service == NULL)
+		{
+			return NULL;
+		}
 	}
 
-	service_destroy(reply);
+	service->id = service_new_id();
+	service->type = type;
+	service->data = NULL;
+	service->data_borrowed = false;
+	service->caller_id = NULL;
+	service->caller_id_buf[0] = '\0';
+	service->shm_mappings = NULL;
+	service->shm_owned = NULL;
+	service->pool_next = NULL;
+
+	return service;
+}
 
-	if (request_context->service != NULL)
+static void service_shm_release_pending(void)
+{
+	service_shm_pending_s *pending;
+
+	pthread_mutex_lock(&service_shm_pending_lock);
+
+	while (service_shm_pending != NULL)
 	{
-		service_destroy(request_context->service);
+		pending = service_shm_pending;
+		service_shm_pending = pending->next;
+		shm_unlink(pending->name);
+		free(pending);
 	}
 
-	free(request_context);
+	pthread_mutex_unlock(&service_shm_pending_lock);
 }
 
+// the segments must not outlive the sender if no receiver has mapped them
+static void service_shm_register_exit_handler(void)
+{
+	atexit(service_shm_release_pending);
+}
 
-int service_create(service_h *service)
+static Eina_Bool service_shm_release_timeout(void *data)
 {
-	return service_create_request(NULL, service);
+	service_shm_pending_s *pending = data;
+	service_shm_pending_s **node;
+
+	pthread_mutex_lock(&service_shm_pending_lock);
+
+	for (node = &service_shm_pending; *node != NULL; node = &(*node)->next)
+	{
+		if (*node == pending)
+		{
+			*node = pending->next;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&service_shm_pending_lock);
+
+	// the receiver unlinks the segment when it maps it, so this fails harmlessly in the common case
+	shm_unlink(pending->name);
+	free(pending);
+
+	return ECORE_CALLBACK_CANCEL;
+}
+
+static void service_shm_schedule_release(void *data)
+{
+	service_shm_pending_s *pending = data;
+
+	pending->timer = ecore_timer_add(SERVICE_SHM_RELEASE_TIMEOUT, service_shm_release_timeout, pending);
+
+	if (pending->timer == NULL)
+	{
+		service_shm_release_timeout(pending);
+	}
+}
+
+static void service_shm_segment_unref(service_shm_segment_s *segment)
+{
+	service_shm_pending_s *pending;
+
+	if (__sync_sub_and_fetch(&segment->ref, 1) > 0)
+	{
+		return;
+	}
+
+	if (segment->sent == 0)
+	{
+		shm_unlink(segment->name);
+		free(segment);
+		return;
+	}
+
+	pending = calloc(1, sizeof(service_shm_pending_s));
+
+	if (pending == NULL)
+	{
+		shm_unlink(segment->name);
+		free(segment);
+		return;
+	}
+
+	snprintf(pending->name, sizeof(pending->name), "%s", segment->name);
+	free(segment);
+
+	pthread_once(&service_shm_pending_once, service_shm_register_exit_handler);
+
+	pthread_mutex_lock(&service_shm_pending_lock);
+	pending->next = service_shm_pending;
+	service_shm_pending = pending;
+	pthread_mutex_unlock(&service_shm_pending_lock);
+
+	// the handle may be destroyed on any thread, the timer lives on the main loop
+	ecore_main_loop_thread_safe_call_async(service_shm_schedule_release, pending);
+}
+
+static int service_shm_own(service_h service, const char *key, service_shm_segment_s *segment)
+{
+	service_shm_owned_s *owned;
+
+	owned = malloc(sizeof(service_shm_owned_s));
+
+	if (owned == NULL)
+	{
+		return -1;
+	}
+
+	owned->key = strdup(key);
+
+	if (owned->key == NULL)
+	{
+		free(owned);
+		return -1;
+	}
+
+	__sync_add_and_fetch(&segment->ref, 1);
+
+	owned->segment = segment;
+	owned->next = service->shm_owned;
+	service->shm_owned = owned;
+
+	return 0;
+}
+
+// the key NULL releases all the segments of the handle
+static void service_shm_disown(service_h service, const char *key)
+{
+	service_shm_owned_s **node = &service->shm_owned;
+	service_shm_owned_s *owned;
+
+	while (*node != NULL)
+	{
+		owned = *node;
+
+		if (key != NULL && strcmp(owned->key, key))
+		{
+			node = &owned->next;
+			continue;
+		}
+
+		*node = owned->next;
+		service_shm_segment_unref(owned->segment);
+		free(owned->key);
+		free(owned);
+	}
+}
+
+// the segments attached to a handle being sent can be mapped by the receiver from now on
+static void service_shm_mark_sent(service_h service)
+{
+	service_shm_owned_s *owned;
+
+	for (owned = service->shm_owned; owned != NULL; owned = owned->next)
+	{
+		__sync_fetch_and_or(&owned->segment->sent, 1);
+	}
+}
+
+static void service_release(struct service_s *service)
+{
+	service_shm_mapping_s *mapping;
+
+	service_shm_disown(service, NULL);
+
+	while (service->shm_mappings != NULL)
+	{
+		mapping = service->shm_mappings;
+		service->shm_mappings = mapping->next;
+		munmap(mapping->addr, mapping->size);
+		free(mapping->key);
+		free(mapping);
+	}
+
+	if (service->data != NULL && service->data_borrowed == false)
+	{
+		bundle_free(service->data);
+	}
+
+	service->data = NULL;
+
+	if (service->caller_id != service->caller_id_buf)
+	{
+		free(service->caller_id);
+	}
+
+	service->caller_id = NULL;
+
+	pthread_mutex_lock(&service_pool_lock);
+
+	if (service_pool_count < SERVICE_HANDLE_POOL_SIZE)
+	{
+		service->pool_next = service_pool_head;
+		service_pool_head = service;
+		service_pool_count++;
+		service = NULL;
+	}
+
+	pthread_mutex_unlock(&service_pool_lock);
+
+	free(service);
 }
 
 int service_create_request(bundle *data, service_h *service)
@@ -237,15 +613,13 @@ int service_create_request(bundle *data, service_h *service)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	service_request = malloc(sizeof(struct service_s));
+	service_request = service_alloc(SERVICE_TYPE_REQUEST);
 
 	if (service_request == NULL)
 	{
 		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a service handle");
 	}
 
-	service_request->type = SERVICE_TYPE_REQUEST;
-
 	if (data != NULL)
 	{
 		service_request->data = bundle_dup(data);
@@ -257,18 +631,68 @@ int service_create_request(bundle *data, service_h *service)
 
 	if (service_request->data == NULL)
 	{
-		free(service_request);
+		service_release(service_request);
 		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a bundle");
 	}
 
-	service_request->id = service_new_id();
+	*service = service_request;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_adopt_request(bundle *data, service_h *service)
+{
+	struct service_s *service_request;
+
+	if (data == NULL || service == NULL)
+	{
+		if (data != NULL)
+		{
+			bundle_free(data);
+		}
+
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	service_request = service_alloc(SERVICE_TYPE_REQUEST);
+
+	if (service_request == NULL)
+	{
+		bundle_free(data);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a service handle");
+	}
+
+	service_request->data = data;
 
 	*service = service_request;
 
 	return SERVICE_ERROR_NONE;
 }
 
-int service_create_event(bundle *data, struct service_s **service)
+// a borrowed bundle belongs to appcore or appsvc, so it is duplicated before the handle changes it
+static int service_own_data(service_h service)
+{
+	bundle *data;
+
+	if (service->data_borrowed == false)
+	{
+		return 0;
+	}
+
+	data = bundle_dup(service->data);
+
+	if (data == NULL)
+	{
+		return -1;
+	}
+
+	service->data = data;
+	service->data_borrowed = false;
+
+	return 0;
+}
+
+static int service_create_event_internal(bundle *data, bool borrowed, struct service_s **service)
 {
 	struct service_s *service_event;
 
@@ -279,21 +703,32 @@ int service_create_event(bundle *data, struct service_s **service)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	service_event = malloc(sizeof(struct service_s));
+	service_event = service_alloc(SERVICE_TYPE_EVENT);
 
 	if (service_event == NULL)
 	{
 		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a service handle");
 	}	
 
-	service_event->type = SERVICE_TYPE_EVENT;
-	service_event->data = bundle_dup(data);
-	service_event->id = service_new_id();
+	service_event->data = borrowed ? data : bundle_dup(data);
+	service_event->data_borrowed = borrowed;
+
+	if (service_event->data == NULL)
+	{
+		service_release(service_event);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a bundle");
+	}
 
 	operation = appsvc_get_operation(service_event->data);
 
 	if (operation == NULL)
 	{
+		if (service_own_data(service_event) != 0)
+		{
+			service_release(service_event);
+			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+		}
+
 		appsvc_set_operation(service_event->data, SERVICE_OPERATION_DEFAULT);
 	}
 
@@ -302,6 +737,17 @@ int service_create_event(bundle *data, struct service_s **service)
 	return SERVICE_ERROR_NONE;
 }
 
+int service_create_event(bundle *data, struct service_s **service)
+{
+	return service_create_event_internal(data, false, service);
+}
+
+int service_create_event_borrowed(bundle *data, struct service_s **service)
+{
+	return service_create_event_internal(data, true, service);
+}
+
+// the reply bundle is owned by appsvc and stays valid until the reply callback returns
 static int service_create_reply(bundle *data, struct service_s **service)
 {
 	struct service_s *service_reply;
@@ -311,16 +757,15 @@ static int service_create_reply(bundle *data, struct service_s **service)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	service_reply = malloc(sizeof(struct service_s));
+	service_reply = service_alloc(SERVICE_TYPE_REPLY);
 
 	if (service_reply == NULL)
 	{
 		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a service handle");
 	}	
 
-	service_reply->type = SERVICE_TYPE_REPLY;
-	service_reply->data = bundle_dup(data);
-	service_reply->id = service_new_id();
+	service_reply->data = data;
+	service_reply->data_borrowed = true;
 
 	*service = service_reply;
 
@@ -334,9 +779,7 @@ int service_destroy(service_h service)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	bundle_free(service->data);
-	service->data = NULL;
-	free(service);
+	service_release(service);
 
 	return SERVICE_ERROR_NONE;
 }
@@ -360,6 +803,11 @@ int service_set_operation(service_h service, const char *operation)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
 	if (operation != NULL)
 	{
 		if (appsvc_set_operation(service->data, operation) != 0)
@@ -406,6 +854,11 @@ int service_set_uri(service_h service, const char *uri)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
 	if (uri != NULL)
 	{
 		if (appsvc_set_uri(service->data, uri) != 0)
@@ -453,6 +906,11 @@ int service_set_mime(service_h service, const char *mime)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
 	if (mime != NULL)
 	{
 		if (appsvc_set_mime(service->data, mime) != 0)
@@ -513,6 +971,11 @@ int service_set_app_id(service_h service, const char *app_id)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
 	if (app_id != NULL)
 	{
 		if (appsvc_set_pkgname(service->data, app_id) != 0)
@@ -559,6 +1022,11 @@ int service_set_window(service_h service, unsigned int id)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
 	if (id > 0)
 	{
 		if (appsvc_allow_transient_app(service->data, id) != 0)
@@ -600,56 +1068,61 @@ int service_get_window(service_h service, unsigned int *id)
 int service_clone(service_h *clone, service_h service)
 {
 	service_h service_clone;
+	service_shm_owned_s *owned;
 
 	if (service_valiate_service(service) || clone == NULL)
 	{
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	service_clone = malloc(sizeof(struct service_s));
+	service_clone = service_alloc(service->type);
 
 	if (service_clone == NULL)
 	{
 		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a service handle");
 	}
 
-	service_clone->id = service_new_id();
-	service_clone->type = service->type;
 	service_clone->data = bundle_dup(service->data);
 
-	*clone = service_clone;
-
-	return SERVICE_ERROR_NONE;
-}
+	if (service_clone->data == NULL)
+	{
+		service_release(service_clone);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
 
+	// the clone shares the shared memory segments, which are unlinked when the last handle is gone
+	for (owned = service->shm_owned; owned != NULL; owned = owned->next)
+	{
+		if (service_shm_own(service_clone, owned->key, owned->segment) != 0)
+		{
+			service_release(service_clone);
+			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+		}
+	}
 
-int service_send_launch_request(service_h service, service_reply_cb callback, void *user_data)
-{
-	const char *operation;
-	const char *uri;
-	const char *mime;
-	const char *package;
+	*clone = service_clone;
 
-	bool implicit_default_operation = false;
-	int launch_pid;
+	return SERVICE_ERROR_NONE;
+}
 
-	service_request_context_h request_context = NULL;
 
-	if (service_valiate_service(service))
-	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-	}
+static int service_validate_launch_request(service_h service, bool *implicit_default_operation)
+{
+	const char *operation;
+	const char *package;
 
 	operation = appsvc_get_operation(service->data);
 
 	if (operation == NULL)
 	{
-		implicit_default_operation = true;
+		*implicit_default_operation = true;
 		operation = SERVICE_OPERATION_DEFAULT;
 	}
+	else
+	{
+		*implicit_default_operation = false;
+	}
 
-	uri = appsvc_get_uri(service->data);
-	mime = appsvc_get_mime(service->data);
 	package = appsvc_get_pkgname(service->data);
 
 	// operation : default
@@ -661,497 +1134,2178 @@ int service_send_launch_request(service_h service, service_reply_cb callback, vo
 		}
 	}
 
-	if (callback != NULL)
-	{
-		service_h request_clone = NULL;
-
-		request_context = calloc(1, sizeof(struct service_request_context_s));
-
-		if (request_context == NULL)
-		{
-			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
-		}
+	return SERVICE_ERROR_NONE;
+}
 
-		request_context->reply_cb = callback;
+static int service_create_request_context(service_h service, service_reply_cb callback, void *user_data, service_request_context_h *request_context)
+{
+	service_request_context_h request_context_new;
+	service_h request_clone = NULL;
 
-		if (service_clone(&request_clone, service) != SERVICE_ERROR_NONE)
-		{
-			free(request_context);
-			return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to clone the service request handle");
-		}
+	request_context_new = calloc(1, sizeof(struct service_request_context_s));
 
-		request_context->service = request_clone;
-		request_context->user_data = user_data;
+	if (request_context_new == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
 	}
 
-	if (implicit_default_operation == true)
+	if (service_clone(&request_clone, service) != SERVICE_ERROR_NONE)
 	{
-		appsvc_set_operation(service->data, SERVICE_OPERATION_DEFAULT);
+		free(request_context_new);
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to clone the service request handle");
 	}
 
-	launch_pid = appsvc_run_service(service->data, service->id, callback ? service_request_result_broker : NULL, request_context);
+	request_context_new->request_id = request_clone->id;
+	request_context_new->reply_cb = callback;
+	request_context_new->service = request_clone;
+	request_context_new->user_data = user_data;
 
-	if (implicit_default_operation == true)
+	clock_gettime(CLOCK_MONOTONIC, &request_context_new->created);
+
+	*request_context = request_context_new;
+
+	return SERVICE_ERROR_NONE;
+}
+
+static void service_destroy_request_context(service_request_context_h request_context)
+{
+	if (request_context == NULL)
 	{
-		bundle_del(service->data, BUNDLE_KEY_OPERATION);
+		return;
 	}
 
-	if (launch_pid < 0)
+	if (request_context->service != NULL)
 	{
-		return service_error(SERVICE_ERROR_APP_NOT_FOUND, __FUNCTION__, NULL);
+		service_destroy(request_context->service);
 	}
 
-	return SERVICE_ERROR_NONE;
+	free(request_context);
 }
 
-static bool service_copy_reply_data_cb(service_h service, const char *key, void *user_data)
+static Eina_Bool service_request_timeout_cb(void *data)
 {
-	bundle *reply_data = user_data;
-	char *value = NULL;
-	char **value_array = NULL;
-	int value_array_length = 0;
-	int value_array_index = 0;
+	int request_id = (int)(intptr_t)data;
+	service_request_context_h request_context;
 
-	if (reply_data == NULL)
-	{
-		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-		return false;
-	}
+	pthread_mutex_lock(&service_pending_requests_lock);
 
-	if (appsvc_data_is_array(service->data, key))
+	for (request_context = service_pending_requests; request_context != NULL; request_context = request_context->next)
 	{
-		service_get_extra_data_array(service, key, &value_array, &value_array_length);
-		appsvc_add_data_array(reply_data, key, (const char**)value_array, value_array_length);
-
-		for (value_array_index=0; value_array_index < value_array_length; value_array_index++)
+		if (request_context->request_id == request_id)
 		{
-			free(value_array[value_array_index]);
+			// ecore deletes the timer when this callback returns
+			request_context->timer = NULL;
+			break;
 		}
-
-		free(value_array);
 	}
-	else
+
+	pthread_mutex_unlock(&service_pending_requests_lock);
+
+	request_context = service_unregister_request_context(request_id);
+
+	if (request_context != NULL)
 	{
-		service_get_extra_data(service, key, &value);
-		appsvc_add_data(reply_data, key, value);
-		free(value);
+		service_error(SERVICE_ERROR_APP_NOT_FOUND, __FUNCTION__, "no reply was delivered before the timeout");
+		service_complete_request_context(request_context, NULL, SERVICE_RESULT_FAILED);
 	}
 
-	return true;
+	return ECORE_CALLBACK_CANCEL;
 }
 
-int service_reply_to_launch_request(service_h reply, service_h request, service_result_e result)
+// runs on the main loop, and does nothing if the request has completed in the meantime
+static void service_request_timer_start(void *data)
 {
-	bundle *reply_data;
-	int appsvc_result;
+	int request_id = (int)(intptr_t)data;
+	service_request_context_h request_context;
 
-	if (service_valiate_service(reply) || service_valiate_service(request))
-	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-	}
+	pthread_mutex_lock(&service_pending_requests_lock);
 
-	if (appsvc_create_result_bundle(request->data, &reply_data) != 0)
+	for (request_context = service_pending_requests; request_context != NULL; request_context = request_context->next)
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to create a result bundle");
+		if (request_context->request_id == request_id)
+		{
+			if (request_context->timer == NULL && service_request_timeout > 0)
+			{
+				request_context->timer = ecore_timer_add(service_request_timeout / 1000.0,
+					service_request_timeout_cb, (void*)(intptr_t)request_id);
+			}
+			break;
+		}
 	}
 
-	service_foreach_extra_data(reply, service_copy_reply_data_cb, reply_data);
+	pthread_mutex_unlock(&service_pending_requests_lock);
+}
 
-	switch (result)
-	{
-	case SERVICE_RESULT_SUCCEEDED:
-		appsvc_result = APPSVC_RES_OK;
-		break;
+static void service_request_timer_stop(void *data)
+{
+	ecore_timer_del(data);
+}
 
-	case SERVICE_RESULT_FAILED:
-		appsvc_result = APPSVC_RES_NOT_OK;
-		break;
+static void service_register_request_context(service_request_context_h request_context)
+{
+	int timeout;
 
-	case SERVICE_RESULT_CANCELED:
-		appsvc_result = APPSVC_RES_CANCEL;
-		break;
+	pthread_mutex_lock(&service_pending_requests_lock);
 
-	default:
-		appsvc_result = APPSVC_RES_CANCEL;
-		break;
+	request_context->prev = NULL;
+	request_context->next = service_pending_requests;
+
+	if (service_pending_requests != NULL)
+	{
+		service_pending_requests->prev = request_context;
 	}
 
-	appsvc_send_result(reply_data, appsvc_result);
-	
-	return SERVICE_ERROR_NONE;
-}
+	service_pending_requests = request_context;
 
+	timeout = service_request_timeout;
 
-int service_add_extra_data(service_h service, const char *key, const char *value)
+	pthread_mutex_unlock(&service_pending_requests_lock);
+
+	// the request may be registered on the launch thread, but ecore timers belong to the main loop
+	if (timeout > 0)
+	{
+		ecore_main_loop_thread_safe_call_async(service_request_timer_start, (void*)(intptr_t)request_context->request_id);
+	}
+}
+
+// must be called with service_pending_requests_lock held
+static void service_unlink_request_context(service_request_context_h request_context)
 {
-	if (service_valiate_service(service) || service_validate_extra_data(key) || service_validate_extra_data(value))
+	if (request_context->prev != NULL)
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		request_context->prev->next = request_context->next;
+	}
+	else
+	{
+		service_pending_requests = request_context->next;
 	}
 
-	if (service_validate_internal_key(key))
+	if (request_context->next != NULL)
 	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+		request_context->next->prev = request_context->prev;
 	}
 
-	if (appsvc_get_data(service->data, key) != NULL)
+	request_context->prev = NULL;
+	request_context->next = NULL;
+
+	if (request_context->timer != NULL)
 	{
-		// overwrite any existing value
-		bundle_del(service->data, key);
+		ecore_main_loop_thread_safe_call_async(service_request_timer_stop, request_context->timer);
+		request_context->timer = NULL;
 	}
+}
 
-	if (appsvc_add_data(service->data, key, value) != 0)
+static service_request_context_h service_unregister_request_context(int request_id)
+{
+	service_request_context_h request_context;
+
+	pthread_mutex_lock(&service_pending_requests_lock);
+
+	for (request_context = service_pending_requests; request_context != NULL; request_context = request_context->next)
 	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "failed to add data to the appsvc handle");
+		if (request_context->request_id == request_id)
+		{
+			service_unlink_request_context(request_context);
+			break;
+		}
 	}
 
-	return SERVICE_ERROR_NONE;
-}
+	pthread_mutex_unlock(&service_pending_requests_lock);
 
+	return request_context;
+}
 
-int service_add_extra_data_array(service_h service, const char *key, const char* value[], int length)
+static void service_complete_request_context(service_request_context_h request_context, bundle *reply_data, service_result_e result)
 {
-	if (service_valiate_service(service) || service_validate_extra_data(key))
+	service_h reply = NULL;
+
+	if (reply_data != NULL)
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		if (service_create_reply(reply_data, &reply) != SERVICE_ERROR_NONE)
+		{
+			service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to create service reply");
+		}
 	}
-
-	if (value == NULL || length <= 0)
+	else
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid array");
-	}	
+		// the callee never replied, so an empty reply is given to the caller
+		reply = service_alloc(SERVICE_TYPE_REPLY);
 
-	if (service_validate_internal_key(key))
-	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+		if (reply != NULL)
+		{
+			reply->data = bundle_create();
+
+			if (reply->data == NULL)
+			{
+				service_release(reply);
+				reply = NULL;
+			}
+		}
 	}
 
-	if (appsvc_get_data_array(service->data, key, NULL) != NULL)
+	if (reply == NULL)
 	{
-		// overwrite any existing value
-		bundle_del(service->data,key);
+		service_destroy_request_context(request_context);
+		return;
 	}
 
-	if (appsvc_add_data_array(service->data, key, value, length) != 0)
+	if (request_context->reply_cb != NULL)
 	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "failed to add array data to the appsvc handle");		
+		request_context->reply_cb(request_context->service, reply, result, request_context->user_data);
+	}
+	else
+	{
+		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid callback ");
 	}
 
-	return SERVICE_ERROR_NONE;
-}
+	service_destroy(reply);
 
+	service_destroy_request_context(request_context);
+}
 
-int service_remove_extra_data(service_h service, const char *key)
+int service_set_launch_request_timeout(int timeout)
 {
-	if (service_valiate_service(service) || service_validate_extra_data(key))
+	if (timeout < 0)
 	{
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	if (service_validate_internal_key(key))
-	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
-	}
+	pthread_mutex_lock(&service_pending_requests_lock);
+	service_request_timeout = timeout;
+	pthread_mutex_unlock(&service_pending_requests_lock);
 
-	if (bundle_del(service->data, key))
+	return SERVICE_ERROR_NONE;
+}
+
+int service_cancel_launch_request(int request_id)
+{
+	service_request_context_h request_context;
+
+	request_context = service_unregister_request_context(request_id);
+
+	if (request_context == NULL)
 	{
-		return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "no pending launch request with the given ID");
 	}
 
+	service_complete_request_context(request_context, NULL, SERVICE_RESULT_CANCELED);
+
 	return SERVICE_ERROR_NONE;
 }
 
-
-int service_get_extra_data(service_h service, const char *key, char **value)
+int service_expire_launch_requests(int age)
 {
-	const char *data_value;
+	service_request_context_h request_context;
+	service_request_context_h request_context_next;
+	service_request_context_h expired = NULL;
+	struct timespec now;
+	long long pending_time;
 
-	if (service_valiate_service(service) || service_validate_extra_data(key) || value == NULL)
+	if (age < 0)
 	{
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
+	clock_gettime(CLOCK_MONOTONIC, &now);
 
-	if (service_validate_internal_key(key))
+	pthread_mutex_lock(&service_pending_requests_lock);
+
+	for (request_context = service_pending_requests; request_context != NULL; request_context = request_context_next)
 	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
-	}
+		request_context_next = request_context->next;
 
-	data_value = appsvc_get_data(service->data, key);
+		pending_time = (now.tv_sec - request_context->created.tv_sec) * 1000LL
+			+ (now.tv_nsec - request_context->created.tv_nsec) / 1000000;
 
-	if (data_value == NULL)	
-	{
-		if (errno == ENOTSUP)
-		{
-			return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, NULL);
-		}
-		else
+		if (pending_time >= age)
 		{
-			return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+			service_unlink_request_context(request_context);
+			request_context->next = expired;
+			expired = request_context;
 		}
 	}
 
-	*value = strdup(data_value);
+	pthread_mutex_unlock(&service_pending_requests_lock);
+
+	// the reply callbacks are invoked without the lock, since they may send another launch request
+	for (request_context = expired; request_context != NULL; request_context = request_context_next)
+	{
+		request_context_next = request_context->next;
+		service_complete_request_context(request_context, NULL, SERVICE_RESULT_FAILED);
+	}
 
 	return SERVICE_ERROR_NONE;
 }
 
-
-int service_get_extra_data_array(service_h service, const char *key, char ***value, int *length)
+static void service_local_dispatch_job(void *data)
 {
-	const char **array_data;
-	int array_data_length;
-	char **array_data_clone;
-	int i;
+	service_h service = data;
+	service_local_dispatch_cb callback;
+	void *user_data;
 
-	if (service_valiate_service(service) || service_validate_extra_data(key))
+	pthread_mutex_lock(&service_local_dispatcher_lock);
+	callback = service_local_dispatcher;
+	user_data = service_local_dispatcher_data;
+	pthread_mutex_unlock(&service_local_dispatcher_lock);
+
+	if (callback != NULL)
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		callback(service, user_data);
 	}
-
-	if (value == NULL || length == 0)
+	else
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		LOGW("[%s] the local launch request(%d) is discarded", __FUNCTION__, service->id);
 	}
 
-	if (service_validate_internal_key(key))
+	service_destroy(service);
+}
+
+// runs on the main loop, where the request is deferred with a job so that it is never delivered inside the sender
+static void service_local_dispatch_queue(void *data)
+{
+	service_h service = data;
+
+	if (ecore_job_add(service_local_dispatch_job, service) == NULL)
 	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+		LOGW("[%s] failed to queue the local launch request(%d)", __FUNCTION__, service->id);
+		service_local_dispatch_job(service);
 	}
+}
 
-	array_data = appsvc_get_data_array(service->data, key, &array_data_length);
+int service_set_local_dispatcher(const char *app_id, service_local_dispatch_cb callback, void *user_data)
+{
+	char *app_id_dup = NULL;
 
-	if (array_data == NULL)
+	if (callback != NULL)
 	{
-		if (errno == ENOTSUP)
-		{
-			return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, NULL);
-		}
-		else
+		if (app_id == NULL)
 		{
-			return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+			return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 		}
-	}
 
-	array_data_clone = calloc(array_data_length, sizeof(char*));
-
-	if (array_data_clone == NULL)
-	{
-		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
-	}
+		app_id_dup = strdup(app_id);
 
-	for (i=0; i<array_data_length; i++)
-	{
-		if (array_data[i] != NULL)
+		if (app_id_dup == NULL)
 		{
-			array_data_clone[i] = strdup(array_data[i]);
+			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
 		}
 	}
 
-	*value = array_data_clone;
-	*length = array_data_length;
+	pthread_mutex_lock(&service_local_dispatcher_lock);
+	free(service_local_app_id);
+	service_local_app_id = app_id_dup;
+	service_local_dispatcher = callback;
+	service_local_dispatcher_data = user_data;
+	pthread_mutex_unlock(&service_local_dispatcher_lock);
 
 	return SERVICE_ERROR_NONE;
 }
 
-
-int service_is_extra_data_array(service_h service, const char *key, bool *array)
+// the launch request to the application itself is delivered as an event on its main loop instead of through AUL
+static int service_dispatch_local_request(service_h service, bool *dispatched)
 {
-	if (service_valiate_service(service) || service_validate_extra_data(key) || array == NULL)
+	const char *package;
+	bool local;
+	service_h event;
+	char caller_pid[32] = {0, };
+	int retval;
+
+	*dispatched = false;
+
+	package = appsvc_get_pkgname(service->data);
+
+	if (package == NULL)
+	{
+		return SERVICE_ERROR_NONE;
+	}
+
+	pthread_mutex_lock(&service_local_dispatcher_lock);
+	local = service_local_dispatcher != NULL && !strcmp(package, service_local_app_id);
+	pthread_mutex_unlock(&service_local_dispatcher_lock);
+
+	if (local == false)
+	{
+		return SERVICE_ERROR_NONE;
+	}
+
+	retval = service_create_event(service->data, &event);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	snprintf(caller_pid, sizeof(caller_pid), "%d", getpid());
+	bundle_del(event->data, AUL_K_CALLER_PID);
+	bundle_add(event->data, AUL_K_CALLER_PID, caller_pid);
+
+	service_caller_token_attach(event->data);
+	service_trace_attach(event->data, service->id);
+	service_trace_record(event->data, SERVICE_TRACE_STAGE_SEND);
+
+	// the main loop may not run in the calling thread, and it calls back synchronously when it does
+	ecore_main_loop_thread_safe_call_async(service_local_dispatch_queue, event);
+
+	*dispatched = true;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_send_launch_request(service_h service, service_reply_cb callback, void *user_data)
+{
+	bool implicit_default_operation = false;
+	int request_id;
+	int launch_pid;
+	int retval;
+
+	service_request_context_h request_context = NULL;
+
+	if (service_valiate_service(service))
 	{
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	if (service_validate_internal_key(key))
+	retval = service_validate_launch_request(service, &implicit_default_operation);
+
+	if (retval != SERVICE_ERROR_NONE)
 	{
-		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
-	}
+		return retval;
+	}
 
-	if (!appsvc_data_is_array(service->data, key))
+	// the trace and the implicit operation are written into the bundle on the way out
+	if (service_own_data(service) != 0)
 	{
-		*array = false;
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
 	}
-	else
+
+	// the reply needs the launch system to route the result back
+	if (callback == NULL)
 	{
-		*array = true;
+		bool dispatched = false;
+
+		retval = service_dispatch_local_request(service, &dispatched);
+
+		if (dispatched == true)
+		{
+			service_shm_mark_sent(service);
+		}
+
+		if (retval != SERVICE_ERROR_NONE || dispatched == true)
+		{
+			return retval;
+		}
+	}
+
+	if (callback != NULL)
+	{
+		retval = service_create_request_context(service, callback, user_data, &request_context);
+
+		if (retval != SERVICE_ERROR_NONE)
+		{
+			return retval;
+		}
+
+		service_register_request_context(request_context);
+	}
+
+	if (implicit_default_operation == true)
+	{
+		appsvc_set_operation(service->data, SERVICE_OPERATION_DEFAULT);
+	}
+
+	request_id = request_context ? request_context->request_id : service->id;
+
+	service_caller_token_attach(service->data);
+	service_trace_attach(service->data, request_id);
+	service_trace_record(service->data, SERVICE_TRACE_STAGE_SEND);
+
+	// the reply is matched to the pending request with the request code,
+	// and the launch is serialized with the ones running on the async launch threads
+	pthread_mutex_lock(&service_launch_lock);
+	launch_pid = appsvc_run_service(service->data, request_id, callback ? service_request_result_broker : NULL, NULL);
+	pthread_mutex_unlock(&service_launch_lock);
+
+	service_trace_record(service->data, SERVICE_TRACE_STAGE_LAUNCHED);
+	service_trace_detach(service->data);
+	bundle_del(service->data, BUNDLE_KEY_CALLER_TOKEN);
+
+	if (implicit_default_operation == true)
+	{
+		bundle_del(service->data, BUNDLE_KEY_OPERATION);
+	}
+
+	if (launch_pid < 0)
+	{
+		if (request_context != NULL)
+		{
+			service_unregister_request_context(request_context->request_id);
+			service_destroy_request_context(request_context);
+		}
+
+		return service_error(SERVICE_ERROR_APP_NOT_FOUND, __FUNCTION__, NULL);
 	}
 
+	// only a launched request hands its segments over, those of a failed one go with the last handle
+	service_shm_mark_sent(service);
+
 	return SERVICE_ERROR_NONE;
 }
 
+static void service_launch_thread_run(void *data, Ecore_Thread *thread)
+{
+	service_launch_context_h launch_context = data;
+
+	(void)thread;
 
-typedef struct {
-	service_h service;
-	service_extra_data_cb callback;
-	void* user_data;
-	bool foreach_break;
-} foreach_context_extra_data_t;
+	// appsvc and aul keep global state for pending results, so the launches are serialized
+	pthread_mutex_lock(&service_launch_lock);
 
-static void service_cb_broker_bundle_iterator(const char *key, const int type, const bundle_keyval_t *kv, void *user_data)
+	launch_context->launch_pid = appsvc_run_service(launch_context->service->data, launch_context->request_id,
+		launch_context->request_context ? service_request_result_broker : NULL, NULL);
+
+	pthread_mutex_unlock(&service_launch_lock);
+}
+
+static void service_launch_thread_end(void *data, Ecore_Thread *thread)
 {
-	foreach_context_extra_data_t* foreach_context = NULL;
-	service_extra_data_cb extra_data_cb;
+	service_launch_context_h launch_context = data;
+	service_error_e error = SERVICE_ERROR_NONE;
+
+	(void)thread;
 
-	if (key == NULL || !(type == BUNDLE_TYPE_STR || type == BUNDLE_TYPE_STR_ARRAY))
+	if (launch_context->launch_pid < 0)
 	{
-		return;
+		error = service_error(SERVICE_ERROR_APP_NOT_FOUND, __FUNCTION__, NULL);
+
+		// no reply will be delivered for the request that failed to launch
+		if (launch_context->request_context != NULL
+			&& service_unregister_request_context(launch_context->request_id) != NULL)
+		{
+			service_destroy_request_context(launch_context->request_context);
+		}
+	}
+	else
+	{
+		// the clone shares the segments with the handle of the caller
+		service_shm_mark_sent(launch_context->service);
 	}
 
-	foreach_context = (foreach_context_extra_data_t*)user_data;
+	service_trace_record(launch_context->service->data, SERVICE_TRACE_STAGE_LAUNCHED);
 
-	if (foreach_context->foreach_break == true)
+	if (launch_context->launch_cb != NULL)
+	{
+		launch_context->launch_cb(launch_context->service, launch_context->request_id,
+			launch_context->launch_pid, error, launch_context->user_data);
+	}
+
+	service_destroy(launch_context->service);
+	free(launch_context);
+}
+
+// appsvc registers the result callback in a list which the main loop reads, so these launches stay on the main loop
+static void service_launch_job(void *data)
+{
+	service_launch_thread_run(data, NULL);
+	service_launch_thread_end(data, NULL);
+}
+
+int service_send_launch_request_async(service_h service, service_launch_cb launch_cb, service_reply_cb reply_cb, void *user_data, int *request_id)
+{
+	service_launch_context_h launch_context;
+	bool implicit_default_operation = false;
+	int retval;
+
+	if (service_valiate_service(service))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	retval = service_validate_launch_request(service, &implicit_default_operation);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	launch_context = calloc(1, sizeof(struct service_launch_context_s));
+
+	if (launch_context == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	// the caller may modify or destroy the handle while the launch is in progress
+	if (service_clone(&launch_context->service, service) != SERVICE_ERROR_NONE)
+	{
+		free(launch_context);
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to clone the service request handle");
+	}
+
+	if (implicit_default_operation == true)
+	{
+		appsvc_set_operation(launch_context->service->data, SERVICE_OPERATION_DEFAULT);
+	}
+
+	if (reply_cb != NULL)
+	{
+		retval = service_create_request_context(launch_context->service, reply_cb, user_data, &launch_context->request_context);
+
+		if (retval != SERVICE_ERROR_NONE)
+		{
+			service_destroy(launch_context->service);
+			free(launch_context);
+			return retval;
+		}
+	}
+
+	launch_context->launch_cb = launch_cb;
+	launch_context->user_data = user_data;
+	launch_context->launch_pid = -1;
+
+	if (launch_context->request_context != NULL)
+	{
+		launch_context->request_id = launch_context->request_context->request_id;
+		service_register_request_context(launch_context->request_context);
+	}
+	else
+	{
+		launch_context->request_id = launch_context->service->id;
+	}
+
+	if (request_id != NULL)
+	{
+		*request_id = launch_context->request_id;
+	}
+
+	service_caller_token_attach(launch_context->service->data);
+	service_trace_attach(launch_context->service->data, launch_context->request_id);
+	service_trace_record(launch_context->service->data, SERVICE_TRACE_STAGE_SEND);
+
+	if (launch_context->request_context != NULL)
+	{
+		if (ecore_job_add(service_launch_job, launch_context) == NULL)
+		{
+			service_launch_job(launch_context);
+		}
+
+		return SERVICE_ERROR_NONE;
+	}
+
+	// if no thread can be spawned, ecore runs the launch on the main loop and still invokes the end callback
+	ecore_thread_run(service_launch_thread_run, service_launch_thread_end, service_launch_thread_end, launch_context);
+
+	return SERVICE_ERROR_NONE;
+}
+
+// the values are added straight from the reply bundle, without copying them out through the service API first
+static void service_cb_splice_reply_data(const char *key, const int type, const bundle_keyval_t *kv, void *user_data)
+{
+	bundle *reply_data = user_data;
+	void *value = NULL;
+	size_t value_size = 0;
+	void **value_array = NULL;
+	unsigned int value_array_length = 0;
+	size_t *value_array_element_size = NULL;
+
+	if (key == NULL)
 	{
 		return;
 	}
 
-	if (service_validate_internal_key(key))
+	// the shared memory payloads are internal keys, but they carry the extra data of the reply
+	if (service_validate_internal_key(key) && strncmp(BUNDLE_KEY_PREFIX_SHM, key, strlen(BUNDLE_KEY_PREFIX_SHM)) != 0)
 	{
 		return;
 	}
-	
-	extra_data_cb = foreach_context->callback;
 
-	if (extra_data_cb != NULL)
+	switch (type)
 	{
-		bool stop_foreach = false;
-		
-		stop_foreach = !extra_data_cb(foreach_context->service, key, foreach_context->user_data);
-	
-		foreach_context->foreach_break = stop_foreach;
+	case BUNDLE_TYPE_STR:
+		bundle_keyval_get_basic_val((bundle_keyval_t*)kv, &value, &value_size);
+		bundle_add(reply_data, key, value);
+		break;
+
+	case BUNDLE_TYPE_STR_ARRAY:
+		bundle_keyval_get_array_val((bundle_keyval_t*)kv, &value_array, &value_array_length, &value_array_element_size);
+		bundle_add_str_array(reply_data, key, (const char**)value_array, value_array_length);
+		break;
+
+	case BUNDLE_TYPE_BYTE:
+		bundle_keyval_get_basic_val((bundle_keyval_t*)kv, &value, &value_size);
+		bundle_add_byte(reply_data, key, value, value_size);
+		break;
+
+	default:
+		break;
+	}
+}
+
+int service_reply_to_launch_request(service_h reply, service_h request, service_result_e result)
+{
+	bundle *reply_data;
+	int appsvc_result;
+
+	if (service_valiate_service(reply) || service_valiate_service(request))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (appsvc_create_result_bundle(request->data, &reply_data) != 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to create a result bundle");
+	}
+
+	bundle_foreach(reply->data, service_cb_splice_reply_data, reply_data);
+
+	switch (result)
+	{
+	case SERVICE_RESULT_SUCCEEDED:
+		appsvc_result = APPSVC_RES_OK;
+		break;
+
+	case SERVICE_RESULT_FAILED:
+		appsvc_result = APPSVC_RES_NOT_OK;
+		break;
+
+	case SERVICE_RESULT_CANCELED:
+		appsvc_result = APPSVC_RES_CANCEL;
+		break;
+
+	default:
+		appsvc_result = APPSVC_RES_CANCEL;
+		break;
 	}
 
+	// the segments stay with the reply handle, which unlinks them, unless the result is on its way
+	if (appsvc_send_result(reply_data, appsvc_result) == 0)
+	{
+		service_shm_mark_sent(reply);
+	}
+	
+	return SERVICE_ERROR_NONE;
 }
 
 
-int service_foreach_extra_data(service_h service, service_extra_data_cb callback, void *user_data)
+int service_add_extra_data(service_h service, const char *key, const char *value)
 {
-	foreach_context_extra_data_t foreach_context = {
-		.service = service,
-		.callback = callback,
-		.user_data = user_data,
-		.foreach_break = false
-	};
-	
-	if (service_valiate_service(service) || callback == NULL)
+	if (service_valiate_service(service) || service_validate_extra_data(key) || service_validate_extra_data(value))
 	{
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	bundle_foreach(service->data, service_cb_broker_bundle_iterator, &foreach_context);
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
+	if (appsvc_get_data(service->data, key) != NULL)
+	{
+		// overwrite any existing value
+		bundle_del(service->data, key);
+	}
+
+	if (appsvc_add_data(service->data, key, value) != 0)
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "failed to add data to the appsvc handle");
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+int service_add_extra_data_array(service_h service, const char *key, const char* value[], int length)
+{
+	if (service_valiate_service(service) || service_validate_extra_data(key))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (value == NULL || length <= 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid array");
+	}	
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
+	if (appsvc_get_data_array(service->data, key, NULL) != NULL)
+	{
+		// overwrite any existing value
+		bundle_del(service->data,key);
+	}
+
+	if (appsvc_add_data_array(service->data, key, value, length) != 0)
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "failed to add array data to the appsvc handle");		
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+int service_add_extra_data_byte(service_h service, const char *key, const void *value, size_t size)
+{
+	if (service_valiate_service(service) || service_validate_extra_data(key))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (value == NULL || size == 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid byte array");
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
+	if (bundle_get_type(service->data, key) != BUNDLE_TYPE_NONE)
+	{
+		// overwrite any existing value
+		bundle_del(service->data, key);
+	}
+
+	if (bundle_add_byte(service->data, key, value, size) != 0)
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "failed to add byte data to the bundle");
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_get_extra_data_byte(service_h service, const char *key, void **value, size_t *size)
+{
+	void *byte_data = NULL;
+	size_t byte_data_size = 0;
+	void *byte_data_clone;
+	int type;
+
+	if (service_valiate_service(service) || service_validate_extra_data(key) || value == NULL || size == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	type = bundle_get_type(service->data, key);
+
+	if (type == BUNDLE_TYPE_NONE)
+	{
+		return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+	}
+
+	if (type != BUNDLE_TYPE_BYTE || bundle_get_byte(service->data, key, &byte_data, &byte_data_size) != 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, NULL);
+	}
+
+	byte_data_clone = malloc(byte_data_size > 0 ? byte_data_size : 1);
+
+	if (byte_data_clone == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	memcpy(byte_data_clone, byte_data, byte_data_size);
+
+	*value = byte_data_clone;
+	*size = byte_data_size;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_is_extra_data_byte(service_h service, const char *key, bool *byte)
+{
+	if (service_valiate_service(service) || service_validate_extra_data(key) || byte == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (bundle_get_type(service->data, key) == BUNDLE_TYPE_BYTE)
+	{
+		*byte = true;
+	}
+	else
+	{
+		*byte = false;
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+static int service_get_shm_key(const char *key, char *buffer, int size)
+{
+	if (snprintf(buffer, size, "%s%s", BUNDLE_KEY_PREFIX_SHM, key) >= size)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+// the value of the shared memory key is formatted as "<size>:<name>"
+static int service_parse_shm_value(const char *value, size_t *size, const char **name)
+{
+	char *separator = NULL;
+	unsigned long long shm_size;
+
+	shm_size = strtoull(value, &separator, 10);
+
+	if (separator == NULL || separator == value || *separator != ':' || *(separator+1) != '/')
+	{
+		return -1;
+	}
+
+	*size = shm_size;
+	*name = separator + 1;
+
+	return 0;
+}
+
+static int service_remove_extra_data_shm(service_h service, const char *key)
+{
+	char shm_key[TIZEN_PATH_MAX] = {0, };
+	const char *shm_value;
+
+	if (service_get_shm_key(key, shm_key, sizeof(shm_key)))
+	{
+		return SERVICE_ERROR_KEY_NOT_FOUND;
+	}
+
+	shm_value = bundle_get_val(service->data, shm_key);
+
+	if (shm_value == NULL)
+	{
+		return SERVICE_ERROR_KEY_NOT_FOUND;
+	}
+
+	// only the handles which attached the segment hold a reference to it
+	service_shm_disown(service, key);
+
+	bundle_del(service->data, shm_key);
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_add_extra_data_shm(service_h service, const char *key, const void *value, size_t size)
+{
+	static unsigned int shm_sequence = 0;
+	char shm_key[TIZEN_PATH_MAX] = {0, };
+	char shm_value[128] = {0, };
+	service_shm_segment_s *segment;
+	unsigned long long shm_nonce;
+	struct timespec now;
+	void *shm_addr;
+	int shm_fd;
+
+	if (service_valiate_service(service) || service_validate_extra_data(key) || value == NULL || size == 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
+	if (service_get_shm_key(key, shm_key, sizeof(shm_key)))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "the given key is too long");
+	}
+
+	segment = calloc(1, sizeof(service_shm_segment_s));
+
+	if (segment == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	// the random part keeps other processes from guessing the name or creating the segment first
+	if (service_read_random(&shm_nonce, sizeof(shm_nonce)) != 0)
+	{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		shm_nonce = ((unsigned long long)now.tv_sec << 30) ^ (unsigned long long)now.tv_nsec;
+	}
+
+	snprintf(segment->name, sizeof(segment->name), SERVICE_SHM_NAME_FMT, getpid(), __sync_fetch_and_add(&shm_sequence, 1), shm_nonce);
+
+	// only the applications running as the same user can map the payload
+	shm_fd = shm_open(segment->name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+	if (shm_fd < 0)
+	{
+		free(segment);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create the shared memory");
+	}
+
+	if (ftruncate(shm_fd, size) != 0)
+	{
+		close(shm_fd);
+		shm_unlink(segment->name);
+		free(segment);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to allocate the shared memory");
+	}
+
+	shm_addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+	close(shm_fd);
+
+	if (shm_addr == MAP_FAILED)
+	{
+		shm_unlink(segment->name);
+		free(segment);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to map the shared memory");
+	}
+
+	memcpy(shm_addr, value, size);
+	munmap(shm_addr, size);
+
+	// overwrite any existing value
+	service_remove_extra_data_shm(service, key);
+
+	snprintf(shm_value, sizeof(shm_value), "%llu:%s", (unsigned long long)size, segment->name);
+
+	if (bundle_add(service->data, shm_key, shm_value) != 0)
+	{
+		shm_unlink(segment->name);
+		free(segment);
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "failed to add data to the bundle");
+	}
+
+	if (service_shm_own(service, key, segment) != 0)
+	{
+		bundle_del(service->data, shm_key);
+		shm_unlink(segment->name);
+		free(segment);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_get_extra_data_shm(service_h service, const char *key, const void **value, size_t *size)
+{
+	char shm_key[TIZEN_PATH_MAX] = {0, };
+	const char *shm_value;
+	const char *shm_name;
+	size_t shm_size;
+	struct stat shm_stat;
+	service_shm_mapping_s *mapping;
+	void *shm_addr;
+	int shm_fd;
+
+	if (service_valiate_service(service) || service_validate_extra_data(key) || value == NULL || size == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	for (mapping = service->shm_mappings; mapping != NULL; mapping = mapping->next)
+	{
+		if (!strcmp(mapping->key, key))
+		{
+			*value = mapping->addr;
+			*size = mapping->size;
+			return SERVICE_ERROR_NONE;
+		}
+	}
+
+	if (service_get_shm_key(key, shm_key, sizeof(shm_key)))
+	{
+		return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+	}
+
+	shm_value = bundle_get_val(service->data, shm_key);
+
+	if (shm_value == NULL)
+	{
+		return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+	}
+
+	if (service_parse_shm_value(shm_value, &shm_size, &shm_name))
+	{
+		return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, "invalid shared memory attachment");
+	}
+
+	mapping = calloc(1, sizeof(service_shm_mapping_s));
+
+	if (mapping == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	mapping->key = strdup(key);
+
+	if (mapping->key == NULL)
+	{
+		free(mapping);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	shm_fd = shm_open(shm_name, O_RDONLY, 0);
+
+	if (shm_fd < 0)
+	{
+		free(mapping->key);
+		free(mapping);
+		return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, "the shared memory has been released");
+	}
+
+	if (fstat(shm_fd, &shm_stat) != 0 || (size_t)shm_stat.st_size < shm_size)
+	{
+		close(shm_fd);
+		free(mapping->key);
+		free(mapping);
+		return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, "the shared memory is truncated");
+	}
+
+	shm_addr = mmap(NULL, shm_size, PROT_READ, MAP_SHARED, shm_fd, 0);
+	close(shm_fd);
+
+	if (shm_addr == MAP_FAILED)
+	{
+		free(mapping->key);
+		free(mapping);
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to map the shared memory");
+	}
+
+	// the receiver consumes the attachment, the pages are freed once the last mapping is gone
+	if (service->type != SERVICE_TYPE_REQUEST)
+	{
+		shm_unlink(shm_name);
+	}
+
+	mapping->addr = shm_addr;
+	mapping->size = shm_size;
+	mapping->next = service->shm_mappings;
+	service->shm_mappings = mapping;
+
+	*value = shm_addr;
+	*size = shm_size;
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+int service_remove_extra_data(service_h service, const char *key)
+{
+	if (service_valiate_service(service) || service_validate_extra_data(key))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (service_own_data(service) != 0)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to duplicate the bundle");
+	}
+
+	if (bundle_del(service->data, key))
+	{
+		if (service_remove_extra_data_shm(service, key) == SERVICE_ERROR_NONE)
+		{
+			return SERVICE_ERROR_NONE;
+		}
+
+		return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+int service_get_extra_data(service_h service, const char *key, char **value)
+{
+	const char *data_value;
+
+	if (service_valiate_service(service) || service_validate_extra_data(key) || value == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	data_value = appsvc_get_data(service->data, key);
+
+	if (data_value == NULL)	
+	{
+		if (errno == ENOTSUP)
+		{
+			return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, NULL);
+		}
+		else
+		{
+			return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+		}
+	}
+
+	*value = strdup(data_value);
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+int service_get_extra_data_array(service_h service, const char *key, char ***value, int *length)
+{
+	const char **array_data;
+	int array_data_length;
+	char **array_data_clone;
+	int i;
+
+	if (service_valiate_service(service) || service_validate_extra_data(key))
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (value == NULL || length == 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	array_data = appsvc_get_data_array(service->data, key, &array_data_length);
+
+	if (array_data == NULL)
+	{
+		if (errno == ENOTSUP)
+		{
+			return service_error(SERVICE_ERROR_INVALID_DATA_TYPE, __FUNCTION__, NULL);
+		}
+		else
+		{
+			return service_error(SERVICE_ERROR_KEY_NOT_FOUND, __FUNCTION__, NULL);
+		}
+	}
+
+	array_data_clone = calloc(array_data_length, sizeof(char*));
+
+	if (array_data_clone == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	for (i=0; i<array_data_length; i++)
+	{
+		if (array_data[i] != NULL)
+		{
+			array_data_clone[i] = strdup(array_data[i]);
+		}
+	}
+
+	*value = array_data_clone;
+	*length = array_data_length;
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+int service_is_extra_data_array(service_h service, const char *key, bool *array)
+{
+	if (service_valiate_service(service) || service_validate_extra_data(key) || array == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	if (!appsvc_data_is_array(service->data, key))
+	{
+		*array = false;
+	}
+	else
+	{
+		*array = true;
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+typedef struct {
+	service_h service;
+	service_extra_data_cb callback;
+	void* user_data;
+	bool foreach_break;
+} foreach_context_extra_data_t;
+
+static void service_cb_broker_bundle_iterator(const char *key, const int type, const bundle_keyval_t *kv, void *user_data)
+{
+	foreach_context_extra_data_t* foreach_context = NULL;
+	service_extra_data_cb extra_data_cb;
+
+	(void)kv;
+
+	if (key == NULL || !(type == BUNDLE_TYPE_STR || type == BUNDLE_TYPE_STR_ARRAY || type == BUNDLE_TYPE_BYTE))
+	{
+		return;
+	}
+
+	foreach_context = (foreach_context_extra_data_t*)user_data;
+
+	if (foreach_context->foreach_break == true)
+	{
+		return;
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return;
+	}
+	
+	extra_data_cb = foreach_context->callback;
+
+	if (extra_data_cb != NULL)
+	{
+		bool stop_foreach = false;
+		
+		stop_foreach = !extra_data_cb(foreach_context->service, key, foreach_context->user_data);
+	
+		foreach_context->foreach_break = stop_foreach;
+	}
+
+}
+
+
+int service_foreach_extra_data(service_h service, service_extra_data_cb callback, void *user_data)
+{
+	foreach_context_extra_data_t foreach_context = {
+		.service = service,
+		.callback = callback,
+		.user_data = user_data,
+		.foreach_break = false
+	};
+	
+	if (service_valiate_service(service) || callback == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	bundle_foreach(service->data, service_cb_broker_bundle_iterator, &foreach_context);
+
+	return SERVICE_ERROR_NONE;
+}
+
+typedef struct {
+	service_h service;
+	service_app_matched_cb callback;
+	void* user_data;
+	bool foreach_break;
+} foreach_context_launchable_app_t;
+
+int service_cb_broker_foreach_app_matched(const char *package, void *data)
+{
+	foreach_context_launchable_app_t *foreach_context;
+	service_app_matched_cb app_matched_cb;
+
+	if (package == NULL || data == NULL)
+	{
+		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		return -1;
+	}
+
+	foreach_context = (foreach_context_launchable_app_t*)data;
+
+	if (foreach_context->foreach_break == true)
+	{
+		return -1;
+	}
+
+	app_matched_cb = foreach_context->callback;
+
+	if (app_matched_cb != NULL)
+	{
+		bool stop_foreach = false;
+		
+		stop_foreach = !app_matched_cb(foreach_context->service, package, foreach_context->user_data);
+	
+		foreach_context->foreach_break = stop_foreach;
+	}
+
+	return 0;
+}
+
+typedef struct service_app_matched_list_s {
+	int ref;
+	int count;
+	char **app_ids;
+} *service_app_matched_list_h;
+
+typedef struct {
+	char *operation;
+	char *uri;
+	char *mime;
+	service_app_matched_list_h list;
+	unsigned int last_used;
+} service_app_matched_cache_entry_s;
+
+typedef struct {
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+} service_db_signature_s;
+
+static service_app_matched_cache_entry_s app_matched_cache[SERVICE_APP_MATCHED_CACHE_SIZE];
+static unsigned int app_matched_cache_clock = 0;
+static service_db_signature_s app_matched_cache_app_info_db = {0, };
+static service_db_signature_s app_matched_cache_appsvc_db = {0, };
+static pthread_mutex_t app_matched_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void service_app_matched_list_unref(service_app_matched_list_h list)
+{
+	int i;
+
+	if (list == NULL || __sync_sub_and_fetch(&list->ref, 1) > 0)
+	{
+		return;
+	}
+
+	for (i=0; i<list->count; i++)
+	{
+		free(list->app_ids[i]);
+	}
+
+	free(list->app_ids);
+	free(list);
+}
+
+static int service_cb_collect_app_matched(const char *package, void *data)
+{
+	service_app_matched_list_h list = data;
+	char **app_ids;
+
+	if (package == NULL || list == NULL)
+	{
+		return -1;
+	}
+
+	app_ids = realloc(list->app_ids, sizeof(char*) * (list->count + 1));
+
+	if (app_ids == NULL)
+	{
+		return -1;
+	}
+
+	list->app_ids = app_ids;
+	list->app_ids[list->count] = strdup(package);
+
+	if (list->app_ids[list->count] != NULL)
+	{
+		list->count++;
+	}
+
+	return 0;
+}
+
+static bool service_string_equals(const char *a, const char *b)
+{
+	if (a == NULL || b == NULL)
+	{
+		return a == b;
+	}
+
+	return !strcmp(a, b);
+}
+
+static void service_app_matched_cache_clear_entry(service_app_matched_cache_entry_s *entry)
+{
+	free(entry->operation);
+	free(entry->uri);
+	free(entry->mime);
+	service_app_matched_list_unref(entry->list);
+	memset(entry, 0, sizeof(service_app_matched_cache_entry_s));
+}
+
+// sets changed if the database differs from the signature, which is then updated; returns false if the database is missing
+static bool service_db_signature_update(const char *path, service_db_signature_s *signature, bool *changed)
+{
+	struct stat db_stat;
+
+	if (stat(path, &db_stat) != 0)
+	{
+		return false;
+	}
+
+	// the nanoseconds tell apart the writes within the same second, the inode a database replaced by rename
+	*changed = *changed || db_stat.st_ino != signature->ino || db_stat.st_size != signature->size
+		|| db_stat.st_mtim.tv_sec != signature->mtime.tv_sec || db_stat.st_mtim.tv_nsec != signature->mtime.tv_nsec;
+
+	signature->ino = db_stat.st_ino;
+	signature->size = db_stat.st_size;
+	signature->mtime = db_stat.st_mtim;
+
+	return true;
+}
+
+// must be called with app_matched_cache_lock held
+static bool service_app_matched_cache_validate(void)
+{
+	bool changed = false;
+	bool valid;
+	int i;
+
+	// the app database is rewritten whenever a package is installed or uninstalled,
+	// the appsvc database whenever a default application is set or cleared
+	valid = service_db_signature_update(SERVICE_APP_INFO_DB_PATH, &app_matched_cache_app_info_db, &changed)
+		&& service_db_signature_update(SERVICE_APPSVC_DB_PATH, &app_matched_cache_appsvc_db, &changed);
+
+	if (valid == false || changed == true)
+	{
+		for (i=0; i<SERVICE_APP_MATCHED_CACHE_SIZE; i++)
+		{
+			service_app_matched_cache_clear_entry(&app_matched_cache[i]);
+		}
+	}
+
+	return valid;
+}
+
+static service_app_matched_list_h service_app_matched_cache_lookup(const char *operation, const char *uri, const char *mime, bool *cacheable)
+{
+	service_app_matched_list_h list = NULL;
+	int i;
+
+	pthread_mutex_lock(&app_matched_cache_lock);
+
+	*cacheable = service_app_matched_cache_validate();
+
+	if (*cacheable == true)
+	{
+		for (i=0; i<SERVICE_APP_MATCHED_CACHE_SIZE; i++)
+		{
+			service_app_matched_cache_entry_s *entry = &app_matched_cache[i];
+
+			if (entry->list == NULL)
+			{
+				continue;
+			}
+
+			if (service_string_equals(entry->operation, operation)
+				&& service_string_equals(entry->uri, uri)
+				&& service_string_equals(entry->mime, mime))
+			{
+				entry->last_used = ++app_matched_cache_clock;
+				list = entry->list;
+				__sync_add_and_fetch(&list->ref, 1);
+				break;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&app_matched_cache_lock);
+
+	return list;
+}
+
+static void service_app_matched_cache_insert(const char *operation, const char *uri, const char *mime, service_app_matched_list_h list)
+{
+	service_app_matched_cache_entry_s *victim = &app_matched_cache[0];
+	int i;
+
+	pthread_mutex_lock(&app_matched_cache_lock);
+
+	for (i=0; i<SERVICE_APP_MATCHED_CACHE_SIZE; i++)
+	{
+		if (app_matched_cache[i].list == NULL)
+		{
+			victim = &app_matched_cache[i];
+			break;
+		}
+
+		if (app_matched_cache[i].last_used < victim->last_used)
+		{
+			victim = &app_matched_cache[i];
+		}
+	}
+
+	service_app_matched_cache_clear_entry(victim);
+
+	victim->operation = operation ? strdup(operation) : NULL;
+	victim->uri = uri ? strdup(uri) : NULL;
+	victim->mime = mime ? strdup(mime) : NULL;
+
+	if ((operation && !victim->operation) || (uri && !victim->uri) || (mime && !victim->mime))
+	{
+		service_app_matched_cache_clear_entry(victim);
+	}
+	else
+	{
+		victim->list = list;
+		victim->last_used = ++app_matched_cache_clock;
+		__sync_add_and_fetch(&list->ref, 1);
+	}
+
+	pthread_mutex_unlock(&app_matched_cache_lock);
+}
+
+int service_foreach_app_matched(service_h service, service_app_matched_cb callback, void *user_data)
+{
+	foreach_context_launchable_app_t foreach_context = {
+		.service = service,
+		.callback = callback,
+		.user_data = user_data,
+		.foreach_break = false
+	};
+
+	service_app_matched_list_h list;
+	const char *operation;
+	const char *uri;
+	const char *mime;
+	bool cacheable = false;
+	int i;
+
+	if (service_valiate_service(service) || callback == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	operation = appsvc_get_operation(service->data);
+	uri = appsvc_get_uri(service->data);
+	mime = appsvc_get_mime(service->data);
+
+	// appsvc matches the whole URI, its scheme and host, and the MIME type it infers from a file path,
+	// so the whole request is the key; an explicit MIME type is a different key than none
+	list = service_app_matched_cache_lookup(operation, uri, mime, &cacheable);
+
+	if (list == NULL)
+	{
+		if (cacheable == false)
+		{
+			appsvc_get_list(service->data, service_cb_broker_foreach_app_matched, &foreach_context);
+			return SERVICE_ERROR_NONE;
+		}
+
+		list = calloc(1, sizeof(struct service_app_matched_list_s));
+
+		if (list == NULL)
+		{
+			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+		}
+
+		list->ref = 1;
+
+		appsvc_get_list(service->data, service_cb_collect_app_matched, list);
+
+		service_app_matched_cache_insert(operation, uri, mime, list);
+	}
+
+	for (i=0; i<list->count && foreach_context.foreach_break == false; i++)
+	{
+		service_cb_broker_foreach_app_matched(list->app_ids[i], &foreach_context);
+	}
+
+	service_app_matched_list_unref(list);
+
+	return SERVICE_ERROR_NONE;
+}
+
+
+// the identity of the caller is its token, or the start time of the process when the request carries no token
+typedef struct {
+	pid_t pid;
+	bool tokenized;
+	unsigned long long identity;
+	char *app_id;
+	unsigned int last_used;
+} service_caller_cache_entry_s;
+
+static service_caller_cache_entry_s caller_cache[SERVICE_CALLER_CACHE_SIZE];
+static unsigned int caller_cache_clock = 0;
+static pthread_mutex_t caller_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// the start time tells a live process apart from an exited one whose pid has been reused
+static int service_get_process_start_time(pid_t pid, unsigned long long *start_time)
+{
+	char stat_path[64] = {0, };
+	char stat_buf[512] = {0, };
+	char *stat_fields;
+	int stat_fd;
+	ssize_t stat_length;
+
+	snprintf(stat_path, sizeof(stat_path), "/proc/%d/stat", pid);
+
+	stat_fd = open(stat_path, O_RDONLY);
+
+	if (stat_fd < 0)
+	{
+		return -1;
+	}
+
+	stat_length = read(stat_fd, stat_buf, sizeof(stat_buf) - 1);
+	close(stat_fd);
+
+	if (stat_length <= 0)
+	{
+		return -1;
+	}
+
+	stat_buf[stat_length] = '\0';
+
+	// the command name may contain spaces, so the fields are parsed after its closing parenthesis
+	stat_fields = strrchr(stat_buf, ')');
+
+	if (stat_fields == NULL)
+	{
+		return -1;
+	}
+
+	if (sscanf(stat_fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", start_time) != 1)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+static bool service_caller_cache_lookup(pid_t pid, bool tokenized, unsigned long long identity, char *buffer, int size)
+{
+	bool found = false;
+	int i;
+
+	pthread_mutex_lock(&caller_cache_lock);
+
+	for (i=0; i<SERVICE_CALLER_CACHE_SIZE; i++)
+	{
+		service_caller_cache_entry_s *entry = &caller_cache[i];
+
+		if (entry->app_id == NULL || entry->pid != pid)
+		{
+			continue;
+		}
+
+		if (entry->tokenized == tokenized && entry->identity == identity)
+		{
+			entry->last_used = ++caller_cache_clock;
+			snprintf(buffer, size, "%s", entry->app_id);
+			found = true;
+		}
+		else
+		{
+			// the caller has exited and its pid belongs to another process now,
+			// or the same process sent this request without a token
+			free(entry->app_id);
+			memset(entry, 0, sizeof(service_caller_cache_entry_s));
+		}
+
+		break;
+	}
+
+	pthread_mutex_unlock(&caller_cache_lock);
+
+	return found;
+}
+
+static void service_caller_cache_insert(pid_t pid, bool tokenized, unsigned long long identity, const char *app_id)
+{
+	service_caller_cache_entry_s *victim = &caller_cache[0];
+	int i;
+
+	pthread_mutex_lock(&caller_cache_lock);
+
+	for (i=0; i<SERVICE_CALLER_CACHE_SIZE; i++)
+	{
+		if (caller_cache[i].app_id == NULL)
+		{
+			victim = &caller_cache[i];
+			break;
+		}
+
+		if (caller_cache[i].last_used < victim->last_used)
+		{
+			victim = &caller_cache[i];
+		}
+	}
+
+	free(victim->app_id);
+
+	victim->pid = pid;
+	victim->tokenized = tokenized;
+	victim->identity = identity;
+	victim->app_id = strdup(app_id);
+	victim->last_used = ++caller_cache_clock;
+
+	pthread_mutex_unlock(&caller_cache_lock);
+}
+
+static size_t service_app_matched_list_size(service_app_matched_list_h list)
+{
+	size_t size = sizeof(struct service_app_matched_list_s) + sizeof(char*) * list->count;
+	int i;
+
+	for (i=0; i<list->count; i++)
+	{
+		size += strlen(list->app_ids[i]) + 1;
+	}
+
+	return size;
+}
+
+// the caches are refilled on demand, so they can be dropped whenever the system is short of memory
+size_t service_release_memory(void)
+{
+	struct service_s *service;
+	size_t released = 0;
+	int i;
+
+	pthread_mutex_lock(&app_matched_cache_lock);
+
+	for (i=0; i<SERVICE_APP_MATCHED_CACHE_SIZE; i++)
+	{
+		service_app_matched_cache_entry_s *entry = &app_matched_cache[i];
+
+		if (entry->list == NULL)
+		{
+			continue;
+		}
+
+		// a list still referenced by a running foreach is released by its last user
+		if (entry->list->ref == 1)
+		{
+			released += service_app_matched_list_size(entry->list);
+		}
+
+		released += entry->operation != NULL ? strlen(entry->operation) + 1 : 0;
+		released += entry->uri != NULL ? strlen(entry->uri) + 1 : 0;
+		released += entry->mime != NULL ? strlen(entry->mime) + 1 : 0;
+
+		service_app_matched_cache_clear_entry(entry);
+	}
+
+	pthread_mutex_unlock(&app_matched_cache_lock);
+
+	pthread_mutex_lock(&caller_cache_lock);
+
+	for (i=0; i<SERVICE_CALLER_CACHE_SIZE; i++)
+	{
+		if (caller_cache[i].app_id != NULL)
+		{
+			released += strlen(caller_cache[i].app_id) + 1;
+			free(caller_cache[i].app_id);
+			memset(&caller_cache[i], 0, sizeof(service_caller_cache_entry_s));
+		}
+	}
+
+	pthread_mutex_unlock(&caller_cache_lock);
+
+	pthread_mutex_lock(&service_pool_lock);
+
+	while (service_pool_head != NULL)
+	{
+		service = service_pool_head;
+		service_pool_head = service->pool_next;
+		free(service);
+		released += sizeof(struct service_s);
+	}
+
+	service_pool_count = 0;
+
+	pthread_mutex_unlock(&service_pool_lock);
+
+	return released;
+}
+
+static int service_resolve_caller(service_h service, const char **id)
+{
+	const char *bundle_value;
+	const char *token;
+	pid_t caller_pid;
+	unsigned long long identity = 0;
+	bool tokenized;
+	bool identity_valid;
+	char package_buf[TIZEN_PATH_MAX] = {0, };
+	char *caller_id;
+
+	if (service_valiate_service(service) || id == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service->type != SERVICE_TYPE_EVENT)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid service handle type");
+	}
+
+	if (service->caller_id != NULL)
+	{
+		*id = service->caller_id;
+		return SERVICE_ERROR_NONE;
+	}
+
+	bundle_value = bundle_get_val(service->data, AUL_K_ORG_CALLER_PID);
+
+	if (bundle_value == NULL)
+	{
+		bundle_value = bundle_get_val(service->data, AUL_K_CALLER_PID);
+	}
+
+	if (bundle_value == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to retrieve the pid of the caller");
+	}
+
+	caller_pid = atoi(bundle_value);
+
+	if (caller_pid <= 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid pid of the caller");
+	}
+
+	token = bundle_get_val(service->data, BUNDLE_KEY_CALLER_TOKEN);
+
+	if (token != NULL)
+	{
+		identity = strtoull(token, NULL, 16);
+	}
+
+	// a cache hit on the token of the caller costs no I/O, only the requests without one read /proc
+	tokenized = (identity != 0);
+	identity_valid = tokenized || (service_get_process_start_time(caller_pid, &identity) == 0);
+
+	if (!identity_valid || !service_caller_cache_lookup(caller_pid, tokenized, identity, package_buf, sizeof(package_buf)))
+	{
+		if (aul_app_get_pkgname_bypid(caller_pid, package_buf, sizeof(package_buf)) != AUL_R_OK)
+		{
+			return service_error(SERVICE_ERROR_APP_NOT_FOUND, __FUNCTION__, "failed to get the package name of the caller");
+		}
+
+		if (identity_valid)
+		{
+			service_caller_cache_insert(caller_pid, tokenized, identity, package_buf);
+		}
+	}
+
+	if (strlen(package_buf) < sizeof(service->caller_id_buf))
+	{
+		snprintf(service->caller_id_buf, sizeof(service->caller_id_buf), "%s", package_buf);
+		caller_id = service->caller_id_buf;
+	}
+	else
+	{
+		caller_id = strdup(package_buf);
+	}
+
+	if (caller_id == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	service->caller_id = caller_id;
+	*id = caller_id;
 
 	return SERVICE_ERROR_NONE;
 }
 
-typedef struct {
-	service_h service;
-	service_app_matched_cb callback;
-	void* user_data;
-	bool foreach_break;
-} foreach_context_launchable_app_t;
-
-int service_cb_broker_foreach_app_matched(const char *package, void *data)
+int service_get_caller(service_h service, char **package)
 {
-	foreach_context_launchable_app_t *foreach_context;
-	service_app_matched_cb app_matched_cb;
+	const char *caller_id;
+	char *caller_id_dup;
+	int retval;
 
-	if (package == NULL || data == NULL)
+	if (package == NULL)
 	{
-		service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-		return -1;
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
 	}
 
-	foreach_context = (foreach_context_launchable_app_t*)data;
+	retval = service_resolve_caller(service, &caller_id);
 
-	if (foreach_context->foreach_break == true)
+	if (retval != SERVICE_ERROR_NONE)
 	{
-		return -1;
+		return retval;
 	}
 
-	app_matched_cb = foreach_context->callback;
+	caller_id_dup = strdup(caller_id);
 
-	if (app_matched_cb != NULL)
+	if (caller_id_dup == NULL)
 	{
-		bool stop_foreach = false;
-		
-		stop_foreach = !app_matched_cb(foreach_context->service, package, foreach_context->user_data);
-	
-		foreach_context->foreach_break = stop_foreach;
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
 	}
 
-	return 0;
+	*package = caller_id_dup;
+
+	return SERVICE_ERROR_NONE;
 }
 
-int service_foreach_app_matched(service_h service, service_app_matched_cb callback, void *user_data)
+int service_peek_caller(service_h service, const char **id)
 {
-	foreach_context_launchable_app_t foreach_context = {
-		.service = service,
-		.callback = callback,
-		.user_data = user_data,
-		.foreach_break = false
-	};
-
-	if (service_valiate_service(service) || callback == NULL)
-	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
-	}
-
-	appsvc_get_list(service->data, service_cb_broker_foreach_app_matched, &foreach_context);
-
-	return SERVICE_ERROR_NONE;
+	return service_resolve_caller(service, id);
 }
 
+typedef struct {
+	bundle *other;
+	int count;
+	bool equals;
+} service_payload_compare_s;
 
-int service_get_caller(service_h service, char **package)
+static void service_cb_compare_payload(const char *key, const int type, const bundle_keyval_t *kv, void *user_data)
 {
-	const char *bundle_value;
-	pid_t caller_pid;
-	char package_buf[TIZEN_PATH_MAX] = {0, };
-	char *package_dup;
+	service_payload_compare_s *compare = user_data;
+	void *value = NULL;
+	size_t value_size = 0;
+	void **value_array = NULL;
+	unsigned int value_array_length = 0;
+	size_t *value_array_element_size = NULL;
+	const char **other_array;
+	int other_array_length = 0;
+	void *other_value = NULL;
+	size_t other_value_size = 0;
+	unsigned int i;
+
+	if (key == NULL || compare->equals == false)
+	{
+		return;
+	}
 
-	if (service_valiate_service(service) || package == NULL)
+	// every shared memory payload is a segment of its own, so no two requests carrying one are identical
+	if (strncmp(BUNDLE_KEY_PREFIX_SHM, key, strlen(BUNDLE_KEY_PREFIX_SHM)) == 0)
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+		compare->equals = false;
+		return;
 	}
 
-	if (service->type != SERVICE_TYPE_EVENT)
+	if (service_validate_internal_key(key))
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid service handle type");
+		return;
 	}
 
-	bundle_value = bundle_get_val(service->data, AUL_K_ORG_CALLER_PID);
+	compare->count++;
 
-	if (bundle_value == NULL)
+	if (compare->other == NULL)
 	{
-		bundle_value = bundle_get_val(service->data, AUL_K_CALLER_PID);
+		return;
 	}
 
-	if (bundle_value == NULL)
+	if (bundle_get_type(compare->other, key) != type)
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to retrieve the pid of the caller");
+		compare->equals = false;
+		return;
 	}
 
-	caller_pid = atoi(bundle_value);
+	switch (type)
+	{
+	case BUNDLE_TYPE_STR:
+		bundle_keyval_get_basic_val((bundle_keyval_t*)kv, &value, &value_size);
+		compare->equals = service_string_equals(value, bundle_get_val(compare->other, key));
+		break;
 
-	if (caller_pid <= 0)
+	case BUNDLE_TYPE_STR_ARRAY:
+		bundle_keyval_get_array_val((bundle_keyval_t*)kv, &value_array, &value_array_length, &value_array_element_size);
+		other_array = bundle_get_str_array(compare->other, key, &other_array_length);
+
+		if (other_array_length < 0 || (unsigned int)other_array_length != value_array_length)
+		{
+			compare->equals = false;
+			break;
+		}
+
+		for (i = 0; i < value_array_length && compare->equals == true; i++)
+		{
+			compare->equals = service_string_equals(value_array[i], other_array[i]);
+		}
+		break;
+
+	case BUNDLE_TYPE_BYTE:
+		bundle_keyval_get_basic_val((bundle_keyval_t*)kv, &value, &value_size);
+
+		if (bundle_get_byte(compare->other, key, &other_value, &other_value_size) != 0
+			|| other_value_size != value_size
+			|| (value_size > 0 && memcmp(value, other_value, value_size) != 0))
+		{
+			compare->equals = false;
+		}
+		break;
+
+	default:
+		compare->equals = false;
+		break;
+	}
+}
+
+// the payload is the operation, the URI, the MIME type, the caller and every extra data
+bool service_payload_equals(service_h lhs, service_h rhs)
+{
+	service_payload_compare_s lhs_compare = {NULL, 0, true};
+	service_payload_compare_s rhs_compare = {NULL, 0, true};
+
+	if (service_valiate_service(lhs) || service_valiate_service(rhs))
 	{
-		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid pid of the caller");
+		return false;
+	}
+
+	if (!service_string_equals(appsvc_get_operation(lhs->data), appsvc_get_operation(rhs->data))
+		|| !service_string_equals(appsvc_get_uri(lhs->data), appsvc_get_uri(rhs->data))
+		|| !service_string_equals(appsvc_get_mime(lhs->data), appsvc_get_mime(rhs->data)))
+	{
+		return false;
 	}
 
-	if (aul_app_get_pkgname_bypid(caller_pid, package_buf, sizeof(package_buf)) != AUL_R_OK)
+	// the same process is the same caller, which saves resolving the package names
+	if (!service_string_equals(bundle_get_val(lhs->data, AUL_K_ORG_CALLER_PID), bundle_get_val(rhs->data, AUL_K_ORG_CALLER_PID))
+		|| !service_string_equals(bundle_get_val(lhs->data, AUL_K_CALLER_PID), bundle_get_val(rhs->data, AUL_K_CALLER_PID)))
 	{
-		return service_error(SERVICE_ERROR_APP_NOT_FOUND, __FUNCTION__, "failed to get the package name of the caller");
+		return false;
 	}
 
-	package_dup = strdup(package_buf);
+	// the keys of the left side are looked up on the right side, then the counts rule out extra keys on the right
+	lhs_compare.other = rhs->data;
+	bundle_foreach(lhs->data, service_cb_compare_payload, &lhs_compare);
 
-	if (package_dup == NULL)
+	if (lhs_compare.equals == false)
 	{
-		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+		return false;
 	}
 
-	*package = package_dup;
+	bundle_foreach(rhs->data, service_cb_compare_payload, &rhs_compare);
 
-	return SERVICE_ERROR_NONE;
+	return rhs_compare.equals == true && rhs_compare.count == lhs_compare.count;
 }
 
 
@@ -1199,12 +3353,13 @@ int service_import_from_bundle(service_h service, bundle *data)
 		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "failed to duplicate the bundle");
 	}
 
-	if (service->data != NULL)
+	if (service->data != NULL && service->data_borrowed == false)
 	{
 		bundle_free(service->data);
 	}
 
 	service->data = data_dup;
+	service->data_borrowed = false;
 
 	return SERVICE_ERROR_NONE;
 }
@@ -1230,3 +3385,376 @@ int service_export_as_bundle(service_h service, bundle **data)
 	return SERVICE_ERROR_NONE;
 }
 
+typedef struct {
+	unsigned char *buffer;
+	size_t size;
+	size_t offset;
+	unsigned int count;
+	int error;
+} service_encode_context_t;
+
+static void service_encode_write(service_encode_context_t *context, const void *data, size_t length)
+{
+	if (context->buffer != NULL && context->offset + length <= context->size)
+	{
+		memcpy(context->buffer + context->offset, data, length);
+	}
+
+	context->offset += length;
+}
+
+static void service_encode_write_uint32(service_encode_context_t *context, uint32_t value)
+{
+	service_encode_write(context, &value, sizeof(value));
+}
+
+static void service_encode_write_string(service_encode_context_t *context, const char *value)
+{
+	uint32_t length = strlen(value) + 1;
+
+	service_encode_write_uint32(context, length);
+	service_encode_write(context, value, length);
+}
+
+// shared memory payloads and the launch data of the platform are only valid for the running handle
+static bool service_encoding_skips_key(const char *key)
+{
+	if (strncmp(BUNDLE_KEY_PREFIX_SHM, key, strlen(BUNDLE_KEY_PREFIX_SHM)) == 0)
+	{
+		return true;
+	}
+
+	if (strncmp(BUNDLE_KEY_PREFIX_AUL, key, strlen(BUNDLE_KEY_PREFIX_AUL)) == 0)
+	{
+		return true;
+	}
+
+	if (strcmp(BUNDLE_KEY_CALLER_TOKEN, key) == 0)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+static void service_cb_encode_bundle_iterator(const char *key, const int type, const bundle_keyval_t *kv, void *user_data)
+{
+	service_encode_context_t *context = user_data;
+	void *value;
+	size_t value_size;
+	void **array_value;
+	unsigned int array_length;
+	size_t *array_element_size;
+	unsigned char encoding_type;
+	unsigned int i;
+
+	if (key == NULL || context->error != SERVICE_ERROR_NONE || service_encoding_skips_key(key))
+	{
+		return;
+	}
+
+	switch (type)
+	{
+	case BUNDLE_TYPE_STR:
+		encoding_type = SERVICE_ENCODING_TYPE_STR;
+		break;
+
+	case BUNDLE_TYPE_STR_ARRAY:
+		encoding_type = SERVICE_ENCODING_TYPE_STR_ARRAY;
+		break;
+
+	case BUNDLE_TYPE_BYTE:
+		encoding_type = SERVICE_ENCODING_TYPE_BYTE;
+		break;
+
+	default:
+		context->error = SERVICE_ERROR_INVALID_DATA_TYPE;
+		return;
+	}
+
+	service_encode_write(context, &encoding_type, sizeof(encoding_type));
+	service_encode_write_string(context, key);
+
+	if (encoding_type == SERVICE_ENCODING_TYPE_STR_ARRAY)
+	{
+		bundle_keyval_get_array_val((bundle_keyval_t*)kv, &array_value, &array_length, &array_element_size);
+
+		service_encode_write_uint32(context, array_length);
+
+		for (i=0; i<array_length; i++)
+		{
+			service_encode_write_string(context, array_value[i] ? array_value[i] : "");
+		}
+	}
+	else
+	{
+		bundle_keyval_get_basic_val((bundle_keyval_t*)kv, &value, &value_size);
+
+		if (encoding_type == SERVICE_ENCODING_TYPE_STR)
+		{
+			service_encode_write_string(context, value);
+		}
+		else
+		{
+			service_encode_write_uint32(context, value_size);
+			service_encode_write(context, value, value_size);
+		}
+	}
+
+	context->count++;
+}
+
+int service_encode(service_h service, void *buffer, size_t size, size_t *length)
+{
+	service_encode_context_t context = {
+		.buffer = buffer,
+		.size = size,
+		.offset = SERVICE_ENCODING_HEADER_SIZE,
+		.count = 0,
+		.error = SERVICE_ERROR_NONE
+	};
+
+	unsigned char header[SERVICE_ENCODING_HEADER_SIZE] = {0, };
+
+	if (service_valiate_service(service) || length == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	bundle_foreach(service->data, service_cb_encode_bundle_iterator, &context);
+
+	if (context.error != SERVICE_ERROR_NONE)
+	{
+		return service_error(context.error, __FUNCTION__, "the service contains data that cannot be encoded");
+	}
+
+	*length = context.offset;
+
+	if (buffer == NULL)
+	{
+		return SERVICE_ERROR_NONE;
+	}
+
+	if (size < context.offset)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "the buffer is not big enough");
+	}
+
+	memcpy(header, SERVICE_ENCODING_MAGIC, 4);
+	header[4] = SERVICE_ENCODING_VERSION;
+	memcpy(header + 8, &context.count, sizeof(uint32_t));
+	memcpy(buffer, header, SERVICE_ENCODING_HEADER_SIZE);
+
+	return SERVICE_ERROR_NONE;
+}
+
+typedef struct {
+	const unsigned char *buffer;
+	size_t length;
+	size_t offset;
+} service_decode_context_t;
+
+static const void* service_decode_read(service_decode_context_t *context, size_t length)
+{
+	const void *data;
+
+	if (length > context->length - context->offset)
+	{
+		return NULL;
+	}
+
+	data = context->buffer + context->offset;
+	context->offset += length;
+
+	return data;
+}
+
+static bool service_decode_read_uint32(service_decode_context_t *context, uint32_t *value)
+{
+	const void *data = service_decode_read(context, sizeof(uint32_t));
+
+	if (data == NULL)
+	{
+		return false;
+	}
+
+	memcpy(value, data, sizeof(uint32_t));
+
+	return true;
+}
+
+// returns a pointer into the encoded buffer, which must be NUL-terminated
+static const char* service_decode_read_string(service_decode_context_t *context)
+{
+	uint32_t length;
+	const char *value;
+
+	if (service_decode_read_uint32(context, &length) == false || length == 0)
+	{
+		return NULL;
+	}
+
+	value = service_decode_read(context, length);
+
+	if (value == NULL || value[length-1] != '\0')
+	{
+		return NULL;
+	}
+
+	return value;
+}
+
+static int service_decode_bundle(service_decode_context_t *context, unsigned int count, bundle *data)
+{
+	const char *array_buffer[16];
+	const char **array_value = array_buffer;
+	uint32_t array_capacity = sizeof(array_buffer) / sizeof(array_buffer[0]);
+	const unsigned char *encoding_type;
+	const char *key;
+	const void *value;
+	uint32_t value_size;
+	uint32_t array_length;
+	unsigned int i;
+	uint32_t j;
+	int retval = SERVICE_ERROR_NONE;
+
+	for (i=0; i<count && retval == SERVICE_ERROR_NONE; i++)
+	{
+		encoding_type = service_decode_read(context, sizeof(unsigned char));
+		key = service_decode_read_string(context);
+
+		if (encoding_type == NULL || key == NULL || service_encoding_skips_key(key))
+		{
+			retval = SERVICE_ERROR_INVALID_PARAMETER;
+			break;
+		}
+
+		switch (*encoding_type)
+		{
+		case SERVICE_ENCODING_TYPE_STR:
+			value = service_decode_read_string(context);
+
+			if (value == NULL || bundle_add(data, key, value) != 0)
+			{
+				retval = SERVICE_ERROR_INVALID_PARAMETER;
+			}
+			break;
+
+		case SERVICE_ENCODING_TYPE_STR_ARRAY:
+			if (service_decode_read_uint32(context, &array_length) == false || array_length > context->length)
+			{
+				retval = SERVICE_ERROR_INVALID_PARAMETER;
+				break;
+			}
+
+			// the scratch array is grown at most a few times while decoding the whole service
+			if (array_length > array_capacity)
+			{
+				const char **array_grown;
+
+				array_grown = realloc(array_value == array_buffer ? NULL : array_value, sizeof(char*) * array_length);
+
+				if (array_grown == NULL)
+				{
+					retval = SERVICE_ERROR_OUT_OF_MEMORY;
+					break;
+				}
+
+				array_value = array_grown;
+				array_capacity = array_length;
+			}
+
+			for (j=0; j<array_length; j++)
+			{
+				array_value[j] = service_decode_read_string(context);
+
+				if (array_value[j] == NULL)
+				{
+					retval = SERVICE_ERROR_INVALID_PARAMETER;
+					break;
+				}
+			}
+
+			if (retval == SERVICE_ERROR_NONE && bundle_add_str_array(data, key, array_value, array_length) != 0)
+			{
+				retval = SERVICE_ERROR_INVALID_PARAMETER;
+			}
+			break;
+
+		case SERVICE_ENCODING_TYPE_BYTE:
+			if (service_decode_read_uint32(context, &value_size) == false)
+			{
+				retval = SERVICE_ERROR_INVALID_PARAMETER;
+				break;
+			}
+
+			value = service_decode_read(context, value_size);
+
+			if (value == NULL || bundle_add_byte(data, key, value, value_size) != 0)
+			{
+				retval = SERVICE_ERROR_INVALID_PARAMETER;
+			}
+			break;
+
+		default:
+			retval = SERVICE_ERROR_INVALID_DATA_TYPE;
+			break;
+		}
+	}
+
+	if (array_value != array_buffer)
+	{
+		free(array_value);
+	}
+
+	return retval;
+}
+
+int service_decode(const void *buffer, size_t length, service_h *service)
+{
+	service_decode_context_t context = {
+		.buffer = buffer,
+		.length = length,
+		.offset = SERVICE_ENCODING_HEADER_SIZE
+	};
+
+	service_h service_decoded;
+	uint32_t count;
+	int retval;
+
+	if (buffer == NULL || service == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (length < SERVICE_ENCODING_HEADER_SIZE || memcmp(buffer, SERVICE_ENCODING_MAGIC, 4) != 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid encoded service");
+	}
+
+	if (context.buffer[4] != SERVICE_ENCODING_VERSION)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "unsupported encoding version");
+	}
+
+	memcpy(&count, context.buffer + 8, sizeof(uint32_t));
+
+	retval = service_create_request(NULL, &service_decoded);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	retval = service_decode_bundle(&context, count, service_decoded->data);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		service_destroy(service_decoded);
+		return service_error(retval, __FUNCTION__, "failed to decode the service");
+	}
+
+	*service = service_decoded;
+
+	return SERVICE_ERROR_NONE;
+}
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bundle.h>
+#include <appsvc.h>
+#include <dlog.h>
+
+#include <app_service.h>
+#include <app_service_private.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_SERVICE"
+
+#define SERVICE_BUILDER_DEFAULT_KEY_COUNT 8
+#define SERVICE_BUILDER_DEFAULT_SIZE 256
+#define SERVICE_BUILDER_ARRAY_INLINE_LENGTH 32
+
+typedef enum {
+	SERVICE_BUILDER_FIELD_OPERATION,
+	SERVICE_BUILDER_FIELD_URI,
+	SERVICE_BUILDER_FIELD_MIME,
+	SERVICE_BUILDER_FIELD_APP_ID,
+	SERVICE_BUILDER_FIELD_MAX,
+} service_builder_field_e;
+
+// the strings are referred by offsets, so the buffer can be moved when it grows
+typedef struct {
+	size_t key;
+	size_t value;
+	int length; // 0 for a string, or the number of strings in an array
+} service_builder_entry_s;
+
+struct service_builder_s {
+	size_t field[SERVICE_BUILDER_FIELD_MAX]; // offset + 1, or 0 if the field is not set
+	service_builder_entry_s *entries;
+	int entry_count;
+	int entry_capacity;
+	char *buffer;
+	size_t buffer_used;
+	size_t buffer_capacity;
+	void *storage; // NULL while the entries and the buffer are in the same allocation as the builder
+	int block_entries; // the capacity of the allocation of the builder itself
+	size_t block_size;
+};
+
+// the block of the last destroyed builder is kept for the next one, as the service handles are pooled
+static struct service_builder_s *service_builder_cache = NULL;
+
+int service_builder_create(int key_count, size_t size, service_builder_h *builder)
+{
+	service_builder_h builder_new;
+
+	if (key_count < 0 || builder == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (key_count == 0)
+	{
+		key_count = SERVICE_BUILDER_DEFAULT_KEY_COUNT;
+	}
+
+	if (size == 0)
+	{
+		size = SERVICE_BUILDER_DEFAULT_SIZE;
+	}
+
+	builder_new = __sync_lock_test_and_set(&service_builder_cache, NULL);
+
+	if (builder_new != NULL && (builder_new->block_entries < key_count || builder_new->block_size < size))
+	{
+		free(builder_new);
+		builder_new = NULL;
+	}
+
+	if (builder_new != NULL)
+	{
+		key_count = builder_new->block_entries;
+		size = builder_new->block_size;
+	}
+	else
+	{
+		// the builder, the entries and the string buffer share one allocation
+		builder_new = malloc(sizeof(struct service_builder_s) + sizeof(service_builder_entry_s) * key_count + size);
+
+		if (builder_new == NULL)
+		{
+			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+		}
+	}
+
+	memset(builder_new->field, 0, sizeof(builder_new->field));
+	builder_new->entries = (service_builder_entry_s *)(builder_new + 1);
+	builder_new->entry_count = 0;
+	builder_new->entry_capacity = key_count;
+	builder_new->buffer = (char *)(builder_new->entries + key_count);
+	builder_new->buffer_used = 0;
+	builder_new->buffer_capacity = size;
+	builder_new->storage = NULL;
+	builder_new->block_entries = key_count;
+	builder_new->block_size = size;
+
+	*builder = builder_new;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_builder_destroy(service_builder_h builder)
+{
+	if (builder == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	free(builder->storage);
+	builder->storage = NULL;
+
+	if (!__sync_bool_compare_and_swap(&service_builder_cache, NULL, builder))
+	{
+		free(builder);
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+static int service_builder_reserve(service_builder_h builder, int entries, size_t bytes)
+{
+	int entry_capacity = builder->entry_capacity;
+	size_t buffer_capacity = builder->buffer_capacity;
+	void *storage;
+
+	if (builder->entry_count + entries <= entry_capacity && builder->buffer_used + bytes <= buffer_capacity)
+	{
+		return SERVICE_ERROR_NONE;
+	}
+
+	while (builder->entry_count + entries > entry_capacity)
+	{
+		entry_capacity *= 2;
+	}
+
+	while (builder->buffer_used + bytes > buffer_capacity)
+	{
+		buffer_capacity *= 2;
+	}
+
+	storage = malloc(sizeof(service_builder_entry_s) * entry_capacity + buffer_capacity);
+
+	if (storage == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, NULL);
+	}
+
+	memcpy(storage, builder->entries, sizeof(service_builder_entry_s) * builder->entry_count);
+	memcpy((service_builder_entry_s *)storage + entry_capacity, builder->buffer, builder->buffer_used);
+
+	free(builder->storage);
+
+	builder->storage = storage;
+	builder->entries = storage;
+	builder->entry_capacity = entry_capacity;
+	builder->buffer = (char *)(builder->entries + entry_capacity);
+	builder->buffer_capacity = buffer_capacity;
+
+	return SERVICE_ERROR_NONE;
+}
+
+// the space must be reserved by service_builder_reserve()
+static size_t service_builder_append(service_builder_h builder, const char *value)
+{
+	size_t offset = builder->buffer_used;
+	size_t length = strlen(value) + 1;
+
+	memcpy(builder->buffer + offset, value, length);
+	builder->buffer_used += length;
+
+	return offset;
+}
+
+static int service_builder_set_field(service_builder_h builder, service_builder_field_e field, const char *value)
+{
+	int retval;
+
+	if (value == NULL)
+	{
+		builder->field[field] = 0;
+		return SERVICE_ERROR_NONE;
+	}
+
+	retval = service_builder_reserve(builder, 0, strlen(value) + 1);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	builder->field[field] = service_builder_append(builder, value) + 1;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_builder_set_operation(service_builder_h builder, const char *operation)
+{
+	if (builder == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	return service_builder_set_field(builder, SERVICE_BUILDER_FIELD_OPERATION, operation);
+}
+
+int service_builder_set_uri(service_builder_h builder, const char *uri)
+{
+	if (builder == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	return service_builder_set_field(builder, SERVICE_BUILDER_FIELD_URI, uri);
+}
+
+int service_builder_set_mime(service_builder_h builder, const char *mime)
+{
+	if (builder == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	return service_builder_set_field(builder, SERVICE_BUILDER_FIELD_MIME, mime);
+}
+
+int service_builder_set_app_id(service_builder_h builder, const char *app_id)
+{
+	if (builder == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	return service_builder_set_field(builder, SERVICE_BUILDER_FIELD_APP_ID, app_id);
+}
+
+int service_builder_add_extra_data(service_builder_h builder, const char *key, const char *value)
+{
+	service_builder_entry_s *entry;
+	int retval;
+
+	if (builder == NULL || key == NULL || key[0] == '\0' || value == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	retval = service_builder_reserve(builder, 1, strlen(key) + strlen(value) + 2);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	entry = &builder->entries[builder->entry_count++];
+	entry->key = service_builder_append(builder, key);
+	entry->value = service_builder_append(builder, value);
+	entry->length = 0;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_builder_add_extra_data_array(service_builder_h builder, const char *key, const char* value[], int length)
+{
+	service_builder_entry_s *entry;
+	size_t size;
+	int retval;
+	int i;
+
+	if (builder == NULL || key == NULL || key[0] == '\0' || value == NULL || length <= 0)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	if (service_validate_internal_key(key))
+	{
+		return service_error(SERVICE_ERROR_KEY_REJECTED, __FUNCTION__, "the given key is reserved as internal use");
+	}
+
+	size = strlen(key) + 1;
+
+	for (i=0; i<length; i++)
+	{
+		if (value[i] == NULL)
+		{
+			return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid array");
+		}
+
+		size += strlen(value[i]) + 1;
+	}
+
+	retval = service_builder_reserve(builder, 1, size);
+
+	if (retval != SERVICE_ERROR_NONE)
+	{
+		return retval;
+	}
+
+	entry = &builder->entries[builder->entry_count++];
+	entry->key = service_builder_append(builder, key);
+	entry->value = builder->buffer_used;
+	entry->length = length;
+
+	for (i=0; i<length; i++)
+	{
+		service_builder_append(builder, value[i]);
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+// the bundle rejects a key it already has, so the later value replaces it, same as service_add_extra_data()
+static int service_builder_add_entry_to(bundle *data, const char *key, const char *value, int length)
+{
+	const char *array_inline[SERVICE_BUILDER_ARRAY_INLINE_LENGTH];
+	const char **array = array_inline;
+	int retval;
+	int i;
+
+	if (length == 0)
+	{
+		retval = bundle_add(data, key, value);
+
+		if (retval != 0 && bundle_get_type(data, key) != BUNDLE_TYPE_NONE)
+		{
+			bundle_del(data, key);
+			retval = bundle_add(data, key, value);
+		}
+
+		return retval;
+	}
+
+	if (length > SERVICE_BUILDER_ARRAY_INLINE_LENGTH)
+	{
+		array = malloc(sizeof(char *) * length);
+
+		if (array == NULL)
+		{
+			return -1;
+		}
+	}
+
+	for (i=0; i<length; i++)
+	{
+		array[i] = value;
+		value += strlen(value) + 1;
+	}
+
+	retval = bundle_add_str_array(data, key, array, length);
+
+	if (retval != 0 && bundle_get_type(data, key) != BUNDLE_TYPE_NONE)
+	{
+		bundle_del(data, key);
+		retval = bundle_add_str_array(data, key, array, length);
+	}
+
+	if (array != array_inline)
+	{
+		free(array);
+	}
+
+	return retval;
+}
+
+// the bundle is filled straight from the buffer, without the lookups and the copies of the service setters
+int service_builder_build(service_builder_h builder, service_h *service)
+{
+	typedef int (*service_builder_setter)(bundle *, const char *);
+
+	static const service_builder_setter setters[SERVICE_BUILDER_FIELD_MAX] = {
+		[SERVICE_BUILDER_FIELD_OPERATION] = appsvc_set_operation,
+		[SERVICE_BUILDER_FIELD_URI] = appsvc_set_uri,
+		[SERVICE_BUILDER_FIELD_MIME] = appsvc_set_mime,
+		[SERVICE_BUILDER_FIELD_APP_ID] = appsvc_set_pkgname,
+	};
+
+	service_builder_entry_s *entry;
+	bundle *data;
+	int i;
+
+	if (builder == NULL || service == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	data = bundle_create();
+
+	if (data == NULL)
+	{
+		return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to create a bundle");
+	}
+
+	for (i=0; i<SERVICE_BUILDER_FIELD_MAX; i++)
+	{
+		if (builder->field[i] != 0 && setters[i](data, builder->buffer + builder->field[i] - 1) != 0)
+		{
+			bundle_free(data);
+			return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, "invalid field");
+		}
+	}
+
+	for (i=0; i<builder->entry_count; i++)
+	{
+		entry = &builder->entries[i];
+
+		if (service_builder_add_entry_to(data, builder->buffer + entry->key, builder->buffer + entry->value, entry->length) != 0)
+		{
+			bundle_free(data);
+			return service_error(SERVICE_ERROR_OUT_OF_MEMORY, __FUNCTION__, "failed to add data to the bundle");
+		}
+	}
+
+	return service_adopt_request(data, service);
+}
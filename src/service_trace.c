@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <bundle.h>
+#include <dlog.h>
+
+#include <app_service.h>
+#include <app_service_private.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+
+#define LOG_TAG "TIZEN_N_SERVICE"
+
+#define BUNDLE_KEY_TRACE_ID "__APP_SVC_TRACE_ID__"
+
+#define SERVICE_TRACE_ENV "CAPI_APPFW_SERVICE_TRACE"
+#define SERVICE_TRACE_RING_SIZE 256
+
+static const char* service_trace_stage_to_string(service_trace_stage_e stage)
+{
+	switch (stage)
+	{
+	case SERVICE_TRACE_STAGE_SEND:
+		return "SEND";
+
+	case SERVICE_TRACE_STAGE_LAUNCHED:
+		return "LAUNCHED";
+
+	case SERVICE_TRACE_STAGE_RECEIVE:
+		return "RECEIVE";
+
+	case SERVICE_TRACE_STAGE_SERVICE_CB_ENTER:
+		return "SERVICE_CB_ENTER";
+
+	case SERVICE_TRACE_STAGE_SERVICE_CB_EXIT:
+		return "SERVICE_CB_EXIT";
+
+	case SERVICE_TRACE_STAGE_REPLY:
+		return "REPLY";
+
+	default :
+		return "UNKNOWN";
+	}
+}
+
+static service_trace_record_s trace_ring[SERVICE_TRACE_RING_SIZE];
+static unsigned int trace_ring_next = 0;
+static unsigned int trace_ring_count = 0;
+static service_trace_cb trace_cb = NULL;
+static void *trace_cb_data = NULL;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_once_t trace_env_once = PTHREAD_ONCE_INIT;
+static volatile bool trace_enabled = false;
+
+static void service_trace_read_env(void)
+{
+	const char *env = getenv(SERVICE_TRACE_ENV);
+
+	if (env != NULL && env[0] == '1')
+	{
+		trace_enabled = true;
+	}
+}
+
+bool service_trace_is_enabled(void)
+{
+	pthread_once(&trace_env_once, service_trace_read_env);
+
+	return trace_enabled;
+}
+
+int service_trace_set_enabled(bool enable)
+{
+	pthread_once(&trace_env_once, service_trace_read_env);
+
+	trace_enabled = enable;
+
+	return SERVICE_ERROR_NONE;
+}
+
+int service_trace_set_cb(service_trace_cb callback, void *user_data)
+{
+	pthread_mutex_lock(&trace_lock);
+	trace_cb = callback;
+	trace_cb_data = user_data;
+	pthread_mutex_unlock(&trace_lock);
+
+	return SERVICE_ERROR_NONE;
+}
+
+void service_trace_attach(bundle *data, int request_id)
+{
+	char trace_id[32] = {0, };
+
+	if (data == NULL || service_trace_is_enabled() == false)
+	{
+		return;
+	}
+
+	snprintf(trace_id, sizeof(trace_id), "%d:%d", getpid(), request_id);
+
+	bundle_del(data, BUNDLE_KEY_TRACE_ID);
+	bundle_add(data, BUNDLE_KEY_TRACE_ID, trace_id);
+}
+
+void service_trace_detach(bundle *data)
+{
+	if (data == NULL || service_trace_is_enabled() == false)
+	{
+		return;
+	}
+
+	bundle_del(data, BUNDLE_KEY_TRACE_ID);
+}
+
+void service_trace_record_request(int pid, int request_id, service_trace_stage_e stage)
+{
+	service_trace_record_s record;
+	service_trace_cb callback;
+	void *callback_data;
+
+	if (service_trace_is_enabled() == false)
+	{
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &record.timestamp);
+
+	record.pid = pid;
+	record.request_id = request_id;
+	record.stage = stage;
+
+	pthread_mutex_lock(&trace_lock);
+
+	trace_ring[trace_ring_next] = record;
+	trace_ring_next = (trace_ring_next + 1) % SERVICE_TRACE_RING_SIZE;
+
+	if (trace_ring_count < SERVICE_TRACE_RING_SIZE)
+	{
+		trace_ring_count++;
+	}
+
+	callback = trace_cb;
+	callback_data = trace_cb_data;
+
+	pthread_mutex_unlock(&trace_lock);
+
+	if (callback != NULL)
+	{
+		callback(&record, callback_data);
+	}
+}
+
+void service_trace_record(bundle *data, service_trace_stage_e stage)
+{
+	const char *trace_id;
+	int pid;
+	int request_id;
+
+	if (data == NULL || service_trace_is_enabled() == false)
+	{
+		return;
+	}
+
+	// only the requests sent with tracing enabled carry the trace ID
+	trace_id = bundle_get_val(data, BUNDLE_KEY_TRACE_ID);
+
+	if (trace_id == NULL || sscanf(trace_id, "%d:%d", &pid, &request_id) != 2)
+	{
+		return;
+	}
+
+	service_trace_record_request(pid, request_id, stage);
+}
+
+int service_trace_foreach_record(service_trace_record_cb callback, void *user_data)
+{
+	service_trace_record_s records[SERVICE_TRACE_RING_SIZE];
+	unsigned int count;
+	unsigned int first;
+	unsigned int i;
+
+	if (callback == NULL)
+	{
+		return service_error(SERVICE_ERROR_INVALID_PARAMETER, __FUNCTION__, NULL);
+	}
+
+	// the records are copied out, so the callback can run without blocking the traced paths
+	pthread_mutex_lock(&trace_lock);
+
+	count = trace_ring_count;
+	first = (trace_ring_next + SERVICE_TRACE_RING_SIZE - count) % SERVICE_TRACE_RING_SIZE;
+
+	for (i=0; i<count; i++)
+	{
+		records[i] = trace_ring[(first + i) % SERVICE_TRACE_RING_SIZE];
+	}
+
+	pthread_mutex_unlock(&trace_lock);
+
+	for (i=0; i<count; i++)
+	{
+		if (callback(&records[i], user_data) == false)
+		{
+			break;
+		}
+	}
+
+	return SERVICE_ERROR_NONE;
+}
+
+static bool service_trace_dump_record(const service_trace_record_s *record, void *user_data)
+{
+	(void)user_data;
+
+	LOGI("[service-trace] %d:%d %s %ld.%09ld", record->pid, record->request_id,
+		service_trace_stage_to_string(record->stage), (long)record->timestamp.tv_sec, record->timestamp.tv_nsec);
+
+	return true;
+}
+
+int service_trace_dump(void)
+{
+	return service_trace_foreach_record(service_trace_dump_record, NULL);
+}
+
+int service_trace_clear(void)
+{
+	pthread_mutex_lock(&trace_lock);
+	trace_ring_next = 0;
+	trace_ring_count = 0;
+	pthread_mutex_unlock(&trace_lock);
+
+	return SERVICE_ERROR_NONE;
+}